@@ -0,0 +1,210 @@
+/**
+ * @brief Gateway de agregação de estações para execução no Linux
+ *
+ * Recebe os relatórios das estações por UDP e serve a visão consolidada
+ * (mesma página do modo gateway do firmware) por HTTP.
+ *
+ * Uso: gateway_host [-u porta_udp] [-p porta_http] [-s slot_ms]
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "inc/gateway.h"
+
+#define HTTP_PORT 8080
+
+static gateway_t gateway;
+
+/**
+ * @brief Milissegundos desde o início do programa (equivalente a to_ms_since_boot)
+ */
+static uint32_t now_ms(void)
+{
+    static struct timespec start;
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    if (start.tv_sec == 0 && start.tv_nsec == 0)
+    {
+        start = ts;
+    }
+    return (uint32_t)((ts.tv_sec - start.tv_sec) * 1000 + (ts.tv_nsec - start.tv_nsec) / 1000000);
+}
+
+static int open_socket(int type, uint16_t port)
+{
+    int fd = socket(AF_INET, type, 0);
+    if (fd < 0)
+    {
+        perror("socket");
+        exit(1);
+    }
+
+    int yes = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    struct sockaddr_in addr = {0};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        perror("bind");
+        exit(1);
+    }
+    if (type == SOCK_STREAM && listen(fd, 4) < 0)
+    {
+        perror("listen");
+        exit(1);
+    }
+
+    return fd;
+}
+
+static void receive_report(int fd)
+{
+    char line[GATEWAY_REPORT_MAX];
+    gateway_report_t report;
+
+    ssize_t len = recv(fd, line, sizeof(line), 0);
+    if (len <= 0)
+    {
+        return;
+    }
+
+    if (gateway_parse_report(line, (size_t)len, &report))
+    {
+        gateway_ingest(&gateway, &report, now_ms());
+    }else {
+        gateway.rejected++;
+    }
+}
+
+static bool send_all(int fd, const char *data, size_t len)
+{
+    while (len)
+    {
+        ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+/**
+ * @brief Atende uma conexão HTTP com a página consolidada (qualquer caminho)
+ */
+static void serve_http(int listen_fd)
+{
+    char buf[512];
+    int fd = accept(listen_fd, NULL, NULL);
+    if (fd < 0)
+    {
+        return;
+    }
+
+    // O conteúdo do request não é usado; apenas consome o que já chegou
+    (void)recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+
+    static const char header[] =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/html; charset=utf-8\r\n"
+        "Connection: close\r\n"
+        "\r\n";
+
+    bool ok = send_all(fd, header, sizeof(header) - 1);
+
+    gateway_cursor_t cursor;
+    gateway_cursor_init(&cursor);
+    uint32_t now = now_ms();
+    while (ok && !gateway_render_done(&cursor))
+    {
+        size_t n = gateway_render(&gateway, &cursor, buf, sizeof(buf), now);
+        if (n == 0)
+        {
+            break;
+        }
+        ok = send_all(fd, buf, n);
+    }
+
+    close(fd);
+}
+
+int main(int argc, char **argv)
+{
+    uint16_t udp_port = GATEWAY_PORT;
+    uint16_t http_port = HTTP_PORT;
+    uint32_t slot_ms = GATEWAY_SLOT_MS;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "u:p:s:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'u':
+            udp_port = (uint16_t)atoi(optarg);
+            break;
+        case 'p':
+            http_port = (uint16_t)atoi(optarg);
+            break;
+        case 's':
+            slot_ms = (uint32_t)atol(optarg);
+            break;
+        default:
+            fprintf(stderr, "Uso: %s [-u porta_udp] [-p porta_http] [-s slot_ms]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    gateway_init(&gateway, slot_ms);
+    now_ms();
+
+    struct pollfd fds[2] = {
+        {.fd = open_socket(SOCK_DGRAM, udp_port), .events = POLLIN},
+        {.fd = open_socket(SOCK_STREAM, http_port), .events = POLLIN},
+    };
+
+    printf("Gateway: relatorios em UDP %u, pagina em http://localhost:%u/ (slot de %lu ms)\n",
+           udp_port, http_port, (unsigned long)gateway.slot_ms);
+    fflush(stdout);
+
+    while (true)
+    {
+        if (poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            perror("poll");
+            return 1;
+        }
+        if (fds[0].revents & POLLIN)
+        {
+            receive_report(fds[0].fd);
+        }
+        if (fds[1].revents & POLLIN)
+        {
+            serve_http(fds[1].fd);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,165 @@
+/**
+ * @brief Simulação do escalonador adaptativo no computador
+ *
+ * Percorre um perfil sintético do rio (período calmo, cheia e vazante) usando
+ * o mesmo estimador de tendência e o mesmo escalonador do firmware, e informa
+ * o ciclo de trabalho (fração do tempo com a CPU ativa), a quantidade de
+ * leituras/relatórios por ritmo e o atraso até o primeiro relatório em ALERTA.
+ * O resultado é comparado com o comportamento de ritmo fixo (leitura a cada
+ * 1 s e relatório a cada 10 s).
+ *
+ * Uso: sched_sim [-h horas] [-a ms_por_leitura] [-r ms_por_relatorio]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+#include "inc/trend.h"
+#include "inc/scheduler.h"
+
+#define RIVER_LEVEL 5.0f
+#define ALERT_LEVEL 7.0f
+#define DANGER_LEVEL 9.0f
+
+typedef struct {
+    uint64_t samples[3];
+    uint64_t reports[3];
+    uint64_t time_ms[3];
+    double active_ms;
+    int64_t alert_delay_ms;   // -1 se não houve relatório em ALERTA
+} sim_result_t;
+
+/**
+ * @brief Nível do rio (m) no instante t: 12 h calmo, cheia de 6 h, vazante de 12 h e calmo
+ */
+static float river_profile(double hours)
+{
+    float level = RIVER_LEVEL - 0.5f;
+    if (hours > 12.0 && hours <= 18.0)
+    {
+        level += 5.0f * (float)((hours - 12.0) / 6.0);
+    }else if (hours > 18.0 && hours <= 30.0){
+        level += 5.0f * (float)(1.0 - (hours - 18.0) / 12.0);
+    }
+    return level + 0.005f * sinf((float)hours * 2.0f); // Pequena oscilação (~1 cm/h)
+}
+
+static void simulate(const scheduler_config_t *config, double hours, double sample_cost_ms,
+                     double report_cost_ms, sim_result_t *out)
+{
+    trend_t trend;
+    scheduler_t sched;
+    uint64_t end_ms = (uint64_t)(hours * 3600000.0);
+    int64_t alert_since = -1;
+
+    *out = (sim_result_t){0};
+    out->alert_delay_ms = -1;
+    trend_init(&trend, TREND_ALPHA, TREND_BETA);
+    scheduler_init(&sched, config, 0);
+
+    for (uint64_t t = 0; t < end_ms;)
+    {
+        uint32_t now = (uint32_t)t;
+        float level = river_profile(t / 3600000.0);
+        trend_update(&trend, level, now);
+
+        bool urgent = level >= ALERT_LEVEL;
+        bool attention = level > RIVER_LEVEL;
+        if (urgent && alert_since < 0)
+        {
+            alert_since = (int64_t)t;
+        }
+
+        scheduler_update(&sched, urgent, attention, trend_rate_per_hour(&trend), now);
+        out->samples[sched.mode]++;
+        out->active_ms += sample_cost_ms;
+
+        if (scheduler_report_due(&sched, now))
+        {
+            out->reports[sched.mode]++;
+            out->active_ms += report_cost_ms;
+            if (urgent && out->alert_delay_ms < 0)
+            {
+                out->alert_delay_ms = (int64_t)t - alert_since;
+            }
+        }
+
+        uint32_t interval = scheduler_sample_interval(&sched);
+        out->time_ms[sched.mode] += interval;
+        t += interval;
+    }
+}
+
+static void print_result(const char *name, const sim_result_t *r, double hours, bool per_mode)
+{
+    static const char *modes[] = {"lento", "normal", "rapido"};
+    double total_ms = hours * 3600000.0;
+    uint64_t samples = 0, reports = 0;
+
+    printf("\n%s\n", name);
+    if (per_mode)
+    {
+        printf("  %-8s %8s %10s %10s\n", "Ritmo", "Tempo", "Leituras", "Relatorios");
+    }
+    for (int m = SCHED_FAST; m >= SCHED_SLOW; m--)
+    {
+        samples += r->samples[m];
+        reports += r->reports[m];
+        if (per_mode)
+        {
+            printf("  %-8s %7.1f%% %10llu %10llu\n", modes[m], 100.0 * r->time_ms[m] / total_ms,
+                   (unsigned long long)r->samples[m], (unsigned long long)r->reports[m]);
+        }
+    }
+    printf("  Total: %llu leituras, %llu relatorios\n", (unsigned long long)samples, (unsigned long long)reports);
+    printf("  Ciclo de trabalho: %.3f%%\n", 100.0 * r->active_ms / total_ms);
+    if (r->alert_delay_ms >= 0)
+    {
+        printf("  Atraso ate o primeiro relatorio em ALERTA: %.1f s\n", r->alert_delay_ms / 1000.0);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    double hours = 48.0;
+    double sample_cost_ms = 25.0;   // ADC + atualização do display via I2C
+    double report_cost_ms = 5.0;    // Formatação e envio do relatório
+    int opt;
+
+    while ((opt = getopt(argc, argv, "h:a:r:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'h': hours = atof(optarg); break;
+        case 'a': sample_cost_ms = atof(optarg); break;
+        case 'r': report_cost_ms = atof(optarg); break;
+        default:
+            fprintf(stderr, "Uso: %s [-h horas] [-a ms_por_leitura] [-r ms_por_relatorio]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    scheduler_config_t adaptive;
+    scheduler_default_config(&adaptive);
+
+    // Comportamento anterior: leitura a cada 1 s e relatório a cada 10 s, sempre
+    scheduler_config_t fixed = adaptive;
+    for (int m = SCHED_SLOW; m <= SCHED_FAST; m++)
+    {
+        fixed.sample_ms[m] = 1000;
+        fixed.report_ms[m] = 10000;
+    }
+
+    sim_result_t r_adaptive, r_fixed;
+    simulate(&adaptive, hours, sample_cost_ms, report_cost_ms, &r_adaptive);
+    simulate(&fixed, hours, sample_cost_ms, report_cost_ms, &r_fixed);
+
+    printf("Simulacao de %.0f h (%.0f ms por leitura, %.0f ms por relatorio)\n",
+           hours, sample_cost_ms, report_cost_ms);
+    print_result("Ritmo adaptativo", &r_adaptive, hours, true);
+    print_result("Ritmo fixo (1 s / 10 s)", &r_fixed, hours, false);
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+/**
+ * @brief Estação simulada para testes do gateway em localhost
+ *
+ * Envia periodicamente relatórios no formato do gateway com uma onda de
+ * cheia sintética (pulso gaussiano no nível do rio). Executando várias
+ * estações com atrasos diferentes, o gateway deve estimar o atraso da onda
+ * entre elas.
+ *
+ * Uso: sim_station [-a ip] [-u porta] [-i estacao] [-t periodo_ms] [-d atraso_ms] [-n relatorios]
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "inc/gateway.h"
+
+/**
+ * @brief Status calculado a partir do nível, como em set_river_status() (sem chuva)
+ */
+static uint8_t level_status(float level)
+{
+    if (level >= 9.0f) return gateway_status_index("PERIGO");
+    if (level > 5.0f) return gateway_status_index("ATENCAO");
+    return gateway_status_index("SEGURO");
+}
+
+static void sleep_ms(uint32_t ms)
+{
+    struct timespec ts = {ms / 1000, (long)(ms % 1000) * 1000000L};
+    nanosleep(&ts, NULL);
+}
+
+int main(int argc, char **argv)
+{
+    const char *address = "127.0.0.1";
+    uint16_t port = GATEWAY_PORT;
+    uint16_t station = 1;
+    uint32_t period_ms = 1000;
+    uint32_t delay_ms = 0;
+    uint32_t count = 200;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "a:u:i:t:d:n:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'a': address = optarg; break;
+        case 'u': port = (uint16_t)atoi(optarg); break;
+        case 'i': station = (uint16_t)atoi(optarg); break;
+        case 't': period_ms = (uint32_t)atol(optarg); break;
+        case 'd': delay_ms = (uint32_t)atol(optarg); break;
+        case 'n': count = (uint32_t)atol(optarg); break;
+        default:
+            fprintf(stderr, "Uso: %s [-a ip] [-u porta] [-i estacao] [-t periodo_ms] [-d atraso_ms] [-n relatorios]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in addr = {0};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (fd < 0 || inet_pton(AF_INET, address, &addr.sin_addr) != 1)
+    {
+        fprintf(stderr, "Endereco invalido: %s\n", address);
+        return 1;
+    }
+
+    // Onda de cheia centrada em 60 períodos (mais o atraso da estação), com largura de 15 períodos
+    float center = 60.0f * period_ms + delay_ms;
+    float width = 15.0f * period_ms;
+    float previous = 0.0f;
+    srand(station);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        float t = (float)i * period_ms;
+        float x = (t - center) / width;
+        float noise = ((rand() % 1000) / 1000.0f - 0.5f) * 0.02f;
+
+        gateway_report_t r = {0};
+        r.station = station;
+        r.report_id = i + 1;
+        r.level = 4.0f + 4.5f * expf(-x * x) + noise;
+        r.rain = 30.0f * expf(-x * x);
+        r.trend = i ? (r.level - previous) * 3600000.0f / period_ms : 0.0f;
+        r.status = level_status(r.level);
+        previous = r.level;
+
+        char line[GATEWAY_REPORT_MAX];
+        size_t len = gateway_format_report(line, sizeof(line), &r);
+        sendto(fd, line, len, 0, (struct sockaddr *)&addr, sizeof(addr));
+
+        sleep_ms(period_ms);
+    }
+
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,310 @@
+#include <stdio.h>
+#include "chart.h"
+
+/**
+ * @brief Margens da área das séries (eixos e legendas)
+ */
+#define CHART_LEFT 34
+#define CHART_TOP 8
+#define CHART_RIGHT 30
+#define CHART_BOTTOM 26
+#define CHART_VIEW_W (CHART_LEFT + CHART_PLOT_W + CHART_RIGHT)
+#define CHART_VIEW_H (CHART_TOP + CHART_PLOT_H + CHART_BOTTOM)
+
+/**
+ * @brief Colunas de pixels com pontos (não mais que os intervalos do histórico)
+ */
+#define CHART_COLUMNS (HISTORY_BUCKETS < CHART_PLOT_W ? HISTORY_BUCKETS : CHART_PLOT_W)
+
+/**
+ * @brief Maior texto gerado por uma coluna (fecha e abre polyline e dois pontos)
+ */
+#define CHART_COLUMN_MAX 64
+
+enum chart_stage {
+    CHART_HEADER,
+    CHART_AXES,
+    CHART_LEVEL,
+    CHART_RAIN,
+    CHART_FOOTER,
+    CHART_DONE
+};
+
+/**
+ * @brief Inicia a geração do gráfico com a janela do histórico atual
+ *
+ * A escala e a janela ficam no cursor: se o histórico avançar durante o envio
+ * o gráfico continua consistente (apenas o intervalo mais recente não aparece).
+ */
+void chart_cursor_init(chart_cursor_t *cur, const history_t *h, const chart_scale_t *scale)
+{
+    cur->scale = *scale;
+    cur->first = (int64_t)h->last_bucket - (HISTORY_BUCKETS - 1);
+    cur->column = 0;
+    cur->last_y = -1;
+    cur->held_x = -1;
+    cur->stage = CHART_HEADER;
+    cur->open = false;
+}
+
+bool chart_render_done(const chart_cursor_t *cur)
+{
+    return cur->stage == CHART_DONE;
+}
+
+/**
+ * @brief Converte um valor na coordenada vertical do gráfico
+ */
+static int16_t to_y(int32_t value, float max)
+{
+    int32_t y = CHART_TOP + CHART_PLOT_H - (int32_t)(value * CHART_PLOT_H / max);
+    if (y < CHART_TOP)
+    {
+        return CHART_TOP;
+    }
+    if (y > CHART_TOP + CHART_PLOT_H)
+    {
+        return CHART_TOP + CHART_PLOT_H;
+    }
+    return (int16_t)y;
+}
+
+/**
+ * @brief Menor e maior valor da série (nível em cm, chuva em décimos de %) nos intervalos de uma coluna
+ *
+ * Retorna false se nenhum intervalo da coluna tem leituras.
+ */
+static bool column_range(const history_t *h, const chart_cursor_t *cur, bool rain,
+                         int32_t *min, int32_t *max)
+{
+    uint32_t from = (uint32_t)cur->column * HISTORY_BUCKETS / CHART_COLUMNS;
+    uint32_t to = ((uint32_t)cur->column + 1) * HISTORY_BUCKETS / CHART_COLUMNS;
+    bool found = false;
+
+    for (uint32_t k = from; k < to; k++)
+    {
+        int64_t bucket = cur->first + k;
+        history_bucket_t b;
+
+        if (bucket < 0 || !history_get(h, (uint32_t)bucket, &b))
+        {
+            continue;
+        }
+
+        int32_t lo = rain ? b.rain_min : b.level_min;
+        int32_t hi = rain ? b.rain_max : b.level_max;
+        if (!found || lo < *min)
+        {
+            *min = lo;
+        }
+        if (!found || hi > *max)
+        {
+            *max = hi;
+        }
+        found = true;
+    }
+
+    return found;
+}
+
+/**
+ * @brief Emite o ponto adiado do fim de um trecho horizontal
+ */
+static int flush_held(chart_cursor_t *cur, char *buf, size_t size)
+{
+    if (cur->held_x < 0)
+    {
+        return 0;
+    }
+
+    int n = snprintf(buf, size, "%d,%d ", cur->held_x, cur->last_y);
+    cur->held_x = -1;
+    return n;
+}
+
+/**
+ * @brief Encerra a polyline atual
+ */
+static int close_line(chart_cursor_t *cur, char *buf, size_t size)
+{
+    int n = flush_held(cur, buf, size);
+    n += snprintf(buf + n, size - n, "\"/>\n");
+    cur->open = false;
+    return n;
+}
+
+/**
+ * @brief Gera os pontos de uma série, coluna por coluna, enquanto couberem em buf
+ *
+ * Uma coluna sem leituras encerra a polyline atual, deixando a falha visível.
+ * Em trechos horizontais apenas o primeiro e o último ponto são emitidos.
+ * Retorna o tamanho gerado; a série termina quando cur->column chega ao fim.
+ */
+static size_t render_series(const history_t *h, chart_cursor_t *cur, bool rain, char *buf, size_t size)
+{
+    float max = rain ? cur->scale.rain_max * 10.0f : cur->scale.level_max * 100.0f;
+    size_t len = 0;
+
+    while (cur->column < CHART_COLUMNS && size - len > CHART_COLUMN_MAX)
+    {
+        int32_t min_v, max_v;
+        int n = 0;
+
+        if (!column_range(h, cur, rain, &min_v, &max_v))
+        {
+            if (cur->open)
+            {
+                n = close_line(cur, buf + len, size - len);
+            }
+        }else {
+            int x = CHART_LEFT + cur->column * CHART_PLOT_W / CHART_COLUMNS;
+            int16_t y_low = to_y(min_v, max);
+            int16_t y_high = to_y(max_v, max);
+
+            bool started = cur->open;
+            if (!started)
+            {
+                n = snprintf(buf + len, size - len, "<polyline class=\"%c\" points=\"", rain ? 'c' : 'n');
+                cur->open = true;
+                cur->last_y = y_low;
+            }
+
+            // O extremo mais próximo do ponto anterior vem primeiro, evitando um traço extra
+            int16_t first = y_low, second = y_high;
+            int d_low = y_low > cur->last_y ? y_low - cur->last_y : cur->last_y - y_low;
+            int d_high = y_high > cur->last_y ? y_high - cur->last_y : cur->last_y - y_high;
+            if (d_high < d_low)
+            {
+                first = y_high;
+                second = y_low;
+            }
+
+            if (started && first == second && first == cur->last_y)
+            {
+                cur->held_x = x; // Continua o trecho horizontal; emitido quando a série mudar
+            }else {
+                n += flush_held(cur, buf + len + n, size - len - n);
+                if (first == second)
+                {
+                    n += snprintf(buf + len + n, size - len - n, "%d,%d ", x, first);
+                }else {
+                    n += snprintf(buf + len + n, size - len - n, "%d,%d %d,%d ", x, first, x, second);
+                }
+                cur->last_y = second;
+            }
+        }
+
+        len += n;
+        cur->column++;
+    }
+
+    if (cur->column >= CHART_COLUMNS && cur->open && size - len > CHART_COLUMN_MAX)
+    {
+        len += close_line(cur, buf + len, size - len);
+    }
+
+    return len;
+}
+
+/**
+ * @brief Gera o próximo trecho do gráfico (SVG)
+ *
+ * Cada chamada preenche buf com o máximo possível do trecho atual e avança o
+ * cursor. Retorna 0 quando o gráfico terminou ou quando buf é menor que
+ * CHART_CHUNK_MIN (o cursor não avança nesse caso).
+ */
+size_t chart_render(const history_t *h, chart_cursor_t *cur, char *buf, size_t size)
+{
+    const chart_scale_t *s = &cur->scale;
+    int n = 0;
+
+    if (size < CHART_CHUNK_MIN)
+    {
+        return 0;
+    }
+
+    switch (cur->stage)
+    {
+    case CHART_HEADER:
+        n = snprintf(buf, size,
+            "<svg viewBox=\"0 0 %d %d\" width=\"100%%\" style=\"max-width:640px;background:#fff\">\n"
+            "<style>polyline{fill:none;stroke-width:1.5}.n{stroke:#1565c0}.c{stroke:#2e7d32;stroke-width:1}"
+            ".g{stroke:#ddd}.a{stroke:#f9a825;stroke-dasharray:4}.p{stroke:#c62828;stroke-dasharray:4}"
+            "text{font:9px sans-serif}</style>\n"
+            "<rect x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\" fill=\"none\" stroke=\"#999\"/>\n",
+            CHART_VIEW_W, CHART_VIEW_H, CHART_LEFT, CHART_TOP, CHART_PLOT_W, CHART_PLOT_H);
+        break;
+
+    case CHART_AXES:
+    {
+        float hours = (float)HISTORY_BUCKETS * h->bucket_ms / 3600000.0f;
+        int bottom = CHART_TOP + CHART_PLOT_H;
+        int right = CHART_LEFT + CHART_PLOT_W;
+
+        n = snprintf(buf, size,
+            "<line class=\"g\" x1=\"%d\" y1=\"%d\" x2=\"%d\" y2=\"%d\"/>\n"
+            "<line class=\"a\" x1=\"%d\" y1=\"%d\" x2=\"%d\" y2=\"%d\"/>\n"
+            "<line class=\"p\" x1=\"%d\" y1=\"%d\" x2=\"%d\" y2=\"%d\"/>\n"
+            "<text x=\"%d\" y=\"%d\" text-anchor=\"end\">%.1fm</text>"
+            "<text x=\"%d\" y=\"%d\" text-anchor=\"end\">0m</text>"
+            "<text x=\"%d\" y=\"%d\">%.0f%%</text>"
+            "<text x=\"%d\" y=\"%d\">0%%</text>\n"
+            "<text x=\"%d\" y=\"%d\">-%.0fh</text>"
+            "<text x=\"%d\" y=\"%d\" text-anchor=\"end\">agora</text>\n",
+            CHART_LEFT, CHART_TOP + CHART_PLOT_H / 2, right, CHART_TOP + CHART_PLOT_H / 2,
+            CHART_LEFT, to_y(s->alert_level * 100.0f, s->level_max * 100.0f),
+            right, to_y(s->alert_level * 100.0f, s->level_max * 100.0f),
+            CHART_LEFT, to_y(s->danger_level * 100.0f, s->level_max * 100.0f),
+            right, to_y(s->danger_level * 100.0f, s->level_max * 100.0f),
+            CHART_LEFT - 3, CHART_TOP + 8, s->level_max,
+            CHART_LEFT - 3, bottom,
+            right + 3, CHART_TOP + 8, s->rain_max,
+            right + 3, bottom,
+            CHART_LEFT, bottom + 11, hours,
+            right, bottom + 11);
+        break;
+    }
+
+    case CHART_LEVEL:
+    case CHART_RAIN:
+        n = (int)render_series(h, cur, cur->stage == CHART_RAIN, buf, size);
+        break;
+
+    case CHART_FOOTER:
+        n = snprintf(buf, size,
+            "<text x=\"%d\" y=\"%d\" fill=\"#1565c0\">&#9632; nivel</text>"
+            "<text x=\"%d\" y=\"%d\" fill=\"#2e7d32\">&#9632; chuva</text>"
+            "<text x=\"%d\" y=\"%d\" fill=\"#f9a825\">- - alerta</text>"
+            "<text x=\"%d\" y=\"%d\" fill=\"#c62828\">- - perigo</text>\n"
+            "</svg>\n",
+            CHART_LEFT, CHART_VIEW_H - 2, CHART_LEFT + 60, CHART_VIEW_H - 2,
+            CHART_LEFT + 120, CHART_VIEW_H - 2, CHART_LEFT + 185, CHART_VIEW_H - 2);
+        break;
+
+    default:
+        return 0;
+    }
+
+    if (n < 0 || (size_t)n >= size)
+    {
+        return 0;
+    }
+
+    // Avança para o próximo trecho; as séries avançam por coluna em render_series()
+    if (cur->stage == CHART_LEVEL || cur->stage == CHART_RAIN)
+    {
+        if (cur->column >= CHART_COLUMNS && !cur->open)
+        {
+            cur->column = 0;
+            cur->stage++;
+            if (n == 0)
+            {
+                return chart_render(h, cur, buf, size); // Série sem nenhuma leitura
+            }
+        }
+    }else {
+        cur->stage++;
+    }
+
+    return n;
+}
@@ -0,0 +1,59 @@
+#ifndef CHART_H
+#define CHART_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "history.h"
+
+/**
+ * @brief Gráfico SVG do nível do rio e da chuva a partir do histórico
+ *
+ * O gráfico é gerado em trechos (como a página do gateway), para ser enviado
+ * diretamente pela conexão TCP sem um buffer do tamanho do SVG. Cada série é
+ * reduzida à resolução do gráfico: cada coluna de pixels recebe no máximo dois
+ * pontos (mínimo e máximo dos intervalos que ela cobre), de modo que o tamanho
+ * do SVG é limitado pela largura e os picos continuam visíveis.
+ *
+ * O módulo não depende do SDK, podendo ser compilado também para o host (ver host/).
+ */
+
+/**
+ * @brief Área das séries, em unidades do viewBox (o SVG é escalado pelo navegador)
+ */
+#define CHART_PLOT_W 300
+#define CHART_PLOT_H 100
+
+/**
+ * @brief Menor trecho aceito por chart_render
+ */
+#define CHART_CHUNK_MIN 512
+
+/**
+ * @brief Escala e limites desenhados no gráfico
+ */
+typedef struct {
+    float level_max;      // Nível (m) no topo do gráfico
+    float rain_max;       // Chuva (%) no topo do gráfico
+    float alert_level;    // Linhas de referência (m)
+    float danger_level;
+} chart_scale_t;
+
+/**
+ * @brief Posição da geração incremental do gráfico
+ */
+typedef struct {
+    chart_scale_t scale;
+    int64_t first;        // Intervalo do histórico na borda esquerda (pode ser anterior ao início)
+    uint16_t column;
+    int16_t last_y;       // Último ponto emitido, para ordenar o mínimo/máximo da coluna seguinte
+    int16_t held_x;       // Ponto adiado em um trecho horizontal (-1 se nenhum)
+    uint8_t stage;
+    bool open;            // Há uma polyline aberta na série atual
+} chart_cursor_t;
+
+void chart_cursor_init(chart_cursor_t *cur, const history_t *h, const chart_scale_t *scale);
+bool chart_render_done(const chart_cursor_t *cur);
+size_t chart_render(const history_t *h, chart_cursor_t *cur, char *buf, size_t size);
+
+#endif /* CHART_H */
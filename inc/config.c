@@ -0,0 +1,528 @@
+#include <stdio.h>
+#include <string.h>
+#include "config.h"
+#include "report_uart.h"
+#include "site_config.h"
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+
+/**
+ * @brief Identificação do registro de configuração gravado na flash ("RCFG")
+ */
+#define CONFIG_MAGIC 0x47464352u
+
+/**
+ * @brief A configuração ocupa o último setor da flash
+ */
+#define CONFIG_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+
+typedef struct {
+    uint32_t magic;
+    uint32_t layout;            // sizeof(station_config_t): descarta registros com outro formato
+    uint32_t firmware;          // CRC de CONFIG_FIRMWARE_VERSION: descarta registros de outras versões do firmware
+    station_config_t config;
+    uint32_t crc;
+} config_record_t;
+
+#define CONFIG_RECORD_SIZE (((sizeof(config_record_t) + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE) * FLASH_PAGE_SIZE)
+
+typedef enum {
+    FIELD_FLOAT,
+    FIELD_U16,
+    FIELD_U32,
+    FIELD_STRING
+} field_type_t;
+
+typedef struct {
+    const char *name;
+    field_type_t type;
+    size_t offset;
+    size_t size;     // Tamanho do campo (strings)
+    bool secret;     // Não é exibido em GET /config
+} config_field_t;
+
+#define FIELD(name, type, member) {name, type, offsetof(station_config_t, member), \
+                                   sizeof(((station_config_t *)0)->member), false}
+#define SECRET(name, member) {name, FIELD_STRING, offsetof(station_config_t, member), \
+                              sizeof(((station_config_t *)0)->member), true}
+
+static const config_field_t fields[] = {
+    FIELD("river_level", FIELD_FLOAT, river_level),
+    FIELD("intense_rain", FIELD_FLOAT, intense_rain),
+    FIELD("adc_low", FIELD_U16, adc_low),
+    FIELD("adc_high", FIELD_U16, adc_high),
+    FIELD("alert_level", FIELD_FLOAT, alert_level),
+    FIELD("danger_level", FIELD_FLOAT, danger_level),
+    FIELD("rain_alert", FIELD_FLOAT, rain_alert),
+    FIELD("rain_attention", FIELD_FLOAT, rain_attention),
+    FIELD("sample_fast_ms", FIELD_U32, sched.sample_ms[SCHED_FAST]),
+    FIELD("sample_normal_ms", FIELD_U32, sched.sample_ms[SCHED_NORMAL]),
+    FIELD("sample_slow_ms", FIELD_U32, sched.sample_ms[SCHED_SLOW]),
+    FIELD("report_fast_ms", FIELD_U32, sched.report_ms[SCHED_FAST]),
+    FIELD("report_normal_ms", FIELD_U32, sched.report_ms[SCHED_NORMAL]),
+    FIELD("report_slow_ms", FIELD_U32, sched.report_ms[SCHED_SLOW]),
+    FIELD("fast_rate", FIELD_FLOAT, sched.fast_rate),
+    FIELD("calm_rate", FIELD_FLOAT, sched.calm_rate),
+    FIELD("hold_ms", FIELD_U32, sched.hold_ms),
+    FIELD("wifi_ssid", FIELD_STRING, wifi_ssid),
+    SECRET("wifi_password", wifi_password),
+    SECRET("token", token),
+};
+
+#define FIELD_COUNT (sizeof(fields) / sizeof(fields[0]))
+
+static const char *validate(const station_config_t *cfg);
+
+static station_config_t configs[2];                          // Configuração ativa e a próxima
+static const station_config_t *volatile active = &configs[0];
+static volatile uint32_t acked_version = 0;                 // Última versão confirmada por config_ack()
+static volatile bool save_pending = false;
+
+static union {
+    config_record_t record;
+    uint8_t bytes[CONFIG_RECORD_SIZE];
+} flash_image;
+
+static uint32_t crc32(const uint8_t *data, size_t len)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    while (len--)
+    {
+        crc ^= *data++;
+        for (int i = 0; i < 8; i++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+static uint32_t firmware_id(void)
+{
+    return crc32((const uint8_t *)CONFIG_FIRMWARE_VERSION, sizeof(CONFIG_FIRMWARE_VERSION) - 1);
+}
+
+static void default_config(station_config_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->river_level = CONFIG_RIVER_LEVEL;
+    cfg->intense_rain = CONFIG_INTENSE_RAIN;
+    cfg->adc_low = CONFIG_ADC_LOW;
+    cfg->adc_high = CONFIG_ADC_HIGH;
+    cfg->alert_level = CONFIG_ALERT_LEVEL;
+    cfg->danger_level = CONFIG_DANGER_LEVEL;
+    cfg->rain_alert = CONFIG_RAIN_ALERT;
+    cfg->rain_attention = CONFIG_RAIN_ATTENTION;
+    scheduler_default_config(&cfg->sched);
+    snprintf(cfg->wifi_ssid, sizeof(cfg->wifi_ssid), "%s", WIFI_SSID);
+    snprintf(cfg->wifi_password, sizeof(cfg->wifi_password), "%s", WIFI_PASSWORD);
+    snprintf(cfg->token, sizeof(cfg->token), "%s", CONFIG_TOKEN);
+}
+
+/**
+ * @brief Carrega a configuração gravada na flash ou, se não houver, os valores de site_config.h
+ *
+ * Um registro que não passa pelas verificações de config_update() também é descartado.
+ */
+void config_init(void)
+{
+    const config_record_t *stored = (const config_record_t *)(XIP_BASE + CONFIG_FLASH_OFFSET);
+
+    if (stored->magic == CONFIG_MAGIC && stored->layout == sizeof(station_config_t) &&
+        stored->firmware == firmware_id() &&
+        stored->crc == crc32((const uint8_t *)&stored->config, sizeof(station_config_t)) &&
+        validate(&stored->config) == NULL)
+    {
+        configs[0] = stored->config;
+    }else {
+        default_config(&configs[0]);
+    }
+    active = &configs[0];
+    acked_version = configs[0].version;
+}
+
+/**
+ * @brief Volta aos valores de site_config.h, que substituem a configuração gravada na flash
+ *
+ * Recuperação de credenciais ou token perdidos (botão A mantido pressionado ao
+ * ligar). Deve ser chamada antes de o servidor web ser iniciado.
+ */
+void config_reset(void)
+{
+    default_config(&configs[0]);
+    active = &configs[0];
+    acked_version = configs[0].version;
+    save_pending = true;
+}
+
+/**
+ * @brief Configuração ativa (ler o ponteiro uma vez por uso e acessar os campos por ele)
+ */
+const station_config_t *config_get(void)
+{
+    return active;
+}
+
+/**
+ * @brief Indica se o token ativo ainda é o valor de exemplo de site_config.h
+ */
+bool config_token_is_default(void)
+{
+    return strcmp(active->token, CONFIG_TOKEN_PLACEHOLDER) == 0;
+}
+
+/**
+ * @brief Compara o token informado com o configurado, em tempo constante
+ *
+ * O token de exemplo nunca é aceito.
+ */
+bool config_check_token(const char *token, size_t len)
+{
+    const char *expected = active->token;
+    size_t expected_len = strlen(expected);
+    uint8_t diff = (len != expected_len);
+
+    for (size_t i = 0; i < len; i++)
+    {
+        diff |= (uint8_t)token[i] ^ (uint8_t)expected[i < expected_len ? i : 0];
+    }
+    return expected_len > 0 && diff == 0 && !config_token_is_default();
+}
+
+/**
+ * @brief Decodifica um valor de formulário (application/x-www-form-urlencoded)
+ */
+static bool url_decode(const char *src, size_t len, char *dst, size_t size)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        char c = src[i];
+        if (c == '+')
+        {
+            c = ' ';
+        }else if (c == '%'){
+            unsigned value = 0;
+            if (i + 2 >= len)
+            {
+                return false;
+            }
+            for (int k = 1; k <= 2; k++)
+            {
+                char h = src[i + k];
+                value <<= 4;
+                if (h >= '0' && h <= '9') value |= h - '0';
+                else if (h >= 'A' && h <= 'F') value |= h - 'A' + 10;
+                else if (h >= 'a' && h <= 'f') value |= h - 'a' + 10;
+                else return false;
+            }
+            c = (char)value;
+            i += 2;
+        }
+
+        if (n + 1 >= size)
+        {
+            return false;
+        }
+        dst[n++] = c;
+    }
+
+    dst[n] = '\0';
+    return true;
+}
+
+/**
+ * @brief Converte um número decimal não negativo (sem strtof, que aloca memória na newlib)
+ */
+static bool parse_number(const char *s, float *out, uint32_t *integer_out)
+{
+    uint32_t integer = 0, fraction = 0, scale = 1;
+    bool digits = false;
+
+    for (; *s >= '0' && *s <= '9'; s++)
+    {
+        if (integer > (UINT32_MAX - 9) / 10)
+        {
+            return false;
+        }
+        integer = integer * 10 + (*s - '0');
+        digits = true;
+    }
+    if (*s == '.')
+    {
+        for (s++; *s >= '0' && *s <= '9'; s++)
+        {
+            if (scale < 1000000)
+            {
+                fraction = fraction * 10 + (*s - '0');
+                scale *= 10;
+            }
+            digits = true;
+        }
+    }
+    if (!digits || *s != '\0')
+    {
+        return false;
+    }
+
+    *out = integer + (float)fraction / scale;
+    *integer_out = (scale == 1) ? integer : UINT32_MAX;
+    return true;
+}
+
+static bool set_field(station_config_t *cfg, const config_field_t *field, const char *value)
+{
+    uint8_t *dst = (uint8_t *)cfg + field->offset;
+    float number;
+    uint32_t integer;
+
+    if (field->type == FIELD_STRING)
+    {
+        if (strlen(value) >= field->size)
+        {
+            return false;
+        }
+        strcpy((char *)dst, value);
+        return true;
+    }
+
+    if (!parse_number(value, &number, &integer))
+    {
+        return false;
+    }
+
+    switch (field->type)
+    {
+    case FIELD_FLOAT:
+        memcpy(dst, &number, sizeof(float));
+        return true;
+    case FIELD_U16:
+        if (integer > UINT16_MAX)
+        {
+            return false;
+        }
+        uint16_t u16 = (uint16_t)integer;
+        memcpy(dst, &u16, sizeof(u16));
+        return true;
+    case FIELD_U32:
+        if (integer == UINT32_MAX)
+        {
+            return false;
+        }
+        memcpy(dst, &integer, sizeof(integer));
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Verifica a consistência de uma configuração; retorna a mensagem de erro ou NULL
+ */
+static const char *validate(const station_config_t *cfg)
+{
+    if (cfg->river_level <= 0.0f || cfg->intense_rain <= 0.0f)
+        return "river_level e intense_rain devem ser positivos";
+    // verify_river_level() mede o deslocamento a partir do centro do joystick (2048)
+    if (cfg->adc_low >= cfg->adc_high || cfg->adc_low > 2048 || cfg->adc_high < 2048 || cfg->adc_high > 4095)
+        return "zona morta invalida (adc_low <= 2048 <= adc_high <= 4095)";
+    if (!(cfg->river_level < cfg->alert_level && cfg->alert_level < cfg->danger_level))
+        return "niveis invalidos (river_level < alert_level < danger_level)";
+    if (cfg->rain_alert > 100.0f || cfg->rain_attention > 100.0f)
+        return "limites de chuva devem estar entre 0 e 100";
+    for (int m = SCHED_SLOW; m <= SCHED_FAST; m++)
+    {
+        if (cfg->sched.sample_ms[m] < 100 || cfg->sched.report_ms[m] < cfg->sched.sample_ms[m])
+            return "intervalos invalidos (sample >= 100 ms e report >= sample)";
+    }
+    if (cfg->sched.calm_rate >= cfg->sched.fast_rate)
+        return "calm_rate deve ser menor que fast_rate";
+    if (cfg->wifi_ssid[0] == '\0' || strlen(cfg->token) < 8)
+        return "wifi_ssid vazio ou token com menos de 8 caracteres";
+    if (strcmp(cfg->token, CONFIG_TOKEN_PLACEHOLDER) == 0)
+        return "token de exemplo nao e aceito";
+    return NULL;
+}
+
+/**
+ * @brief Indica se uma nova alteração pode ser aplicada
+ *
+ * Depois de uma troca, a cópia livre é a configuração anterior, que ainda pode
+ * estar em uso pelo laço principal até a próxima chamada de config_ack().
+ */
+bool config_update_ready(void)
+{
+    return active->version == acked_version;
+}
+
+/**
+ * @brief Informa que o laço principal não guarda ponteiros obtidos antes da última troca
+ *
+ * Deve ser chamada no laço principal em pontos onde nenhuma configuração está
+ * em uso. O outro leitor, a página web, roda nos próprios callbacks do lwIP,
+ * que não se interrompem entre si.
+ */
+void config_ack(void)
+{
+    acked_version = active->version;
+}
+
+/**
+ * @brief Aplica os campos de um formulário (campo=valor&campo=valor) à configuração ativa
+ *
+ * Os campos não informados mantêm o valor atual. A nova configuração só passa
+ * a valer se todos os campos forem válidos, com a troca atômica do ponteiro
+ * ativo, e é agendada para gravação na flash. É recusada enquanto a
+ * alteração anterior não foi confirmada pelo laço principal (config_update_ready()).
+ */
+bool config_update(const char *body, size_t len, const char **error)
+{
+    const station_config_t *current = active;
+    station_config_t *next = (current == &configs[0]) ? &configs[1] : &configs[0];
+    char value[72];
+
+    if (!config_update_ready())
+    {
+        *error = "alteracao anterior ainda sendo aplicada";
+        return false;
+    }
+
+    *next = *current;
+
+    const char *p = body;
+    const char *end = body + len;
+    while (p < end)
+    {
+        const char *amp = memchr(p, '&', end - p);
+        const char *pair_end = amp ? amp : end;
+        const char *eq = memchr(p, '=', pair_end - p);
+
+        if (pair_end > p)
+        {
+            if (!eq)
+            {
+                *error = "campo sem valor";
+                return false;
+            }
+
+            const config_field_t *field = NULL;
+            for (size_t i = 0; i < FIELD_COUNT; i++)
+            {
+                if (strlen(fields[i].name) == (size_t)(eq - p) && memcmp(fields[i].name, p, eq - p) == 0)
+                {
+                    field = &fields[i];
+                    break;
+                }
+            }
+            if (!field)
+            {
+                *error = "campo desconhecido";
+                return false;
+            }
+            if (!url_decode(eq + 1, pair_end - eq - 1, value, sizeof(value)) || !set_field(next, field, value))
+            {
+                *error = "valor invalido";
+                return false;
+            }
+        }
+
+        p = pair_end + 1;
+    }
+
+    *error = validate(next);
+    if (*error)
+    {
+        return false;
+    }
+
+    next->version = current->version + 1;
+    __dmb();          // A cópia deve estar completa antes de ser publicada
+    active = next;
+    save_pending = true;
+    return true;
+}
+
+/**
+ * @brief Gera o JSON da configuração (sem a senha do Wi-Fi e o token)
+ *
+ * Retorna o tamanho do texto gerado, ou 0 se não couber em buf.
+ */
+size_t config_format_json(const station_config_t *cfg, char *buf, size_t size)
+{
+    size_t len = 0;
+    bool ok = report_uart_appendf(buf, size, &len, "{\"version\":%lu", (unsigned long)cfg->version);
+
+    for (size_t i = 0; i < FIELD_COUNT && ok; i++)
+    {
+        const config_field_t *field = &fields[i];
+        const uint8_t *src = (const uint8_t *)cfg + field->offset;
+        float f;
+        uint16_t u16;
+        uint32_t u32;
+
+        if (field->secret)
+        {
+            continue;
+        }
+
+        switch (field->type)
+        {
+        case FIELD_FLOAT:
+            memcpy(&f, src, sizeof(f));
+            ok = report_uart_appendf(buf, size, &len, ",\"%s\":%.3f", field->name, f);
+            break;
+        case FIELD_U16:
+            memcpy(&u16, src, sizeof(u16));
+            ok = report_uart_appendf(buf, size, &len, ",\"%s\":%u", field->name, u16);
+            break;
+        case FIELD_U32:
+            memcpy(&u32, src, sizeof(u32));
+            ok = report_uart_appendf(buf, size, &len, ",\"%s\":%lu", field->name, (unsigned long)u32);
+            break;
+        case FIELD_STRING:
+            // Valores com aspas ou barras são omitidos (o JSON é gerado sem escape)
+            ok = report_uart_appendf(buf, size, &len, ",\"%s\":\"%s\"", field->name,
+                                     strpbrk((const char *)src, "\"\\") ? "?" : (const char *)src);
+            break;
+        }
+    }
+
+    ok = ok && report_uart_appendf(buf, size, &len, "}\n");
+    return ok ? len : 0;
+}
+
+static void write_flash(void *param)
+{
+    flash_range_erase(CONFIG_FLASH_OFFSET, FLASH_SECTOR_SIZE);
+    flash_range_program(CONFIG_FLASH_OFFSET, flash_image.bytes, CONFIG_RECORD_SIZE);
+}
+
+/**
+ * @brief Grava na flash a última configuração aplicada, se houver alteração pendente
+ *
+ * Deve ser chamada no laço principal: a gravação bloqueia a execução a partir
+ * da flash (e as interrupções) por algumas dezenas de milissegundos.
+ */
+void config_save_pending(void)
+{
+    if (!save_pending)
+    {
+        return;
+    }
+    save_pending = false;
+
+    memset(&flash_image, 0xFF, sizeof(flash_image));
+    flash_image.record.magic = CONFIG_MAGIC;
+    flash_image.record.layout = sizeof(station_config_t);
+    flash_image.record.firmware = firmware_id();
+    flash_image.record.config = *active;
+    flash_image.record.crc = crc32((const uint8_t *)&flash_image.record.config, sizeof(station_config_t));
+
+    if (flash_safe_execute(write_flash, NULL, 100) != PICO_OK)
+    {
+        save_pending = true; // Tenta novamente na próxima chamada
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "scheduler.h"
+
+/**
+ * @brief Configuração da estação, alterável em tempo de execução
+ *
+ * A configuração ativa nunca é alterada no lugar: uma nova configuração é
+ * montada em outra cópia e passa a valer com a troca de um único ponteiro
+ * (config_get()). Cada troca incrementa version, permitindo que quem guarda
+ * valores derivados (ex.: o escalonador) perceba a mudança. A cópia anterior só
+ * é reutilizada depois que o laço principal confirma, com config_ack(), que não
+ * guarda mais ponteiros obtidos antes da troca.
+ *
+ * As alterações são gravadas no último setor da flash fora dos callbacks de
+ * rede, por config_save_pending(), chamada no laço principal.
+ */
+typedef struct {
+    uint32_t version;            // Incrementado a cada alteração aplicada
+
+    // Calibração dos sensores
+    float river_level;           // Nível normal do rio (m)
+    float intense_rain;          // Intensidade de chuva no fundo de escala (%)
+    uint16_t adc_low;            // Zona morta do ADC do nível (abaixo: rio desceu), <= 2048
+    uint16_t adc_high;           // Zona morta do ADC do nível (acima: rio subiu), >= 2048
+
+    // Limites de classificação do status
+    float alert_level;           // Nível (m) de ALERTA
+    float danger_level;          // Nível (m) de PERIGO
+    float rain_alert;            // Chuva (%) que agrava o status com o rio acima do normal
+    float rain_attention;        // Chuva (%) que gera ATENÇÃO com o rio normal
+
+    scheduler_config_t sched;    // Intervalos de leitura e relatório
+
+    char wifi_ssid[33];          // Aplicado na próxima inicialização
+    char wifi_password[65];      // Aplicado na próxima inicialização
+    char token[33];              // Token exigido pelos endpoints /config
+} station_config_t;
+
+void config_init(void);
+void config_reset(void);
+const station_config_t *config_get(void);
+bool config_token_is_default(void);
+bool config_update_ready(void);
+bool config_update(const char *body, size_t len, const char **error);
+void config_ack(void);
+bool config_check_token(const char *token, size_t len);
+size_t config_format_json(const station_config_t *cfg, char *buf, size_t size);
+void config_save_pending(void);
+
+#endif /* CONFIG_H */
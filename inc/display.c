@@ -0,0 +1,290 @@
+#include <stdio.h>
+#include <string.h>
+#include "display.h"
+
+/**
+ * @brief Área do gráfico: da página GRAPH_PAGE até a última página, em toda a largura
+ */
+#define GRAPH_PAGE 1
+#define GRAPH_TOP (GRAPH_PAGE * 8)
+#define GRAPH_H (HEIGHT - GRAPH_TOP)
+#define LAST_PAGE (HEIGHT / 8 - 1)
+
+/**
+ * @brief Caracteres por linha (ssd1306_draw_string quebra a linha antes do 16º)
+ */
+#define ROW_CHARS 15
+
+static const char *const sched_mode_names[] = {"LENTO", "NORMAL", "RAPIDO"};
+
+/**
+ * @brief Inicializa a interface na tela de status (o display já deve estar configurado)
+ */
+void display_init(display_t *d, ssd1306_t *ssd)
+{
+    memset(d, 0, sizeof(*d));
+    d->ssd = ssd;
+    d->screen = DISPLAY_STATUS;
+    d->graph_from = WIDTH;
+    d->full = true;
+}
+
+/**
+ * @brief Escreve uma linha de texto em uma página, se diferente da exibida
+ */
+static void set_row(display_t *d, uint8_t page, const char *text, bool centered)
+{
+    char row[ROW_CHARS + 1];
+    size_t len = strlen(text);
+
+    if (len > ROW_CHARS)
+    {
+        len = ROW_CHARS;
+    }
+    memcpy(row, text, len);
+    row[len] = '\0';
+
+    if (strcmp(row, d->rows[page]) == 0)
+    {
+        return;
+    }
+    strcpy(d->rows[page], row);
+
+    ssd1306_clear_area(d->ssd, 0, WIDTH - 1, page, page);
+    ssd1306_draw_string(d->ssd, row, centered ? (WIDTH - len * 8) / 2 : 0, page * 8);
+    d->dirty_pages |= 1u << page;
+}
+
+/**
+ * @brief Converte um valor (mesma unidade de max) na linha do gráfico
+ */
+static uint8_t graph_y(int32_t value, float max)
+{
+    int32_t y = HEIGHT - 1 - (int32_t)(value * (GRAPH_H - 1) / max);
+    if (y < GRAPH_TOP)
+    {
+        return GRAPH_TOP;
+    }
+    if (y > HEIGHT - 1)
+    {
+        return HEIGHT - 1;
+    }
+    return (uint8_t)y;
+}
+
+/**
+ * @brief Desenha a coluna x do gráfico com os dados de um intervalo do histórico
+ *
+ * O nível é uma linha vertical do mínimo ao máximo do intervalo, estendida até
+ * a coluna anterior para que a curva fique contínua; a chuva é um ponto no
+ * máximo do intervalo; o nível de ALERTA é uma linha pontilhada.
+ */
+static void draw_column(display_t *d, const history_t *h, uint8_t x, int64_t bucket)
+{
+    const chart_scale_t *s = &d->graph_scale;
+    float level_max = s->level_max * 100.0f;
+    history_bucket_t b, prev;
+
+    ssd1306_clear_area(d->ssd, x, x, GRAPH_PAGE, LAST_PAGE);
+    if (bucket < 0)
+    {
+        return;
+    }
+
+    // O pontilhado acompanha o intervalo, e não a coluna, para se deslocar junto com a curva
+    if (bucket % 4 == 0)
+    {
+        ssd1306_pixel(d->ssd, x, graph_y(s->alert_level * 100.0f, level_max), true);
+    }
+
+    if (!history_get(h, (uint32_t)bucket, &b))
+    {
+        return;
+    }
+
+    uint8_t top = graph_y(b.level_max, level_max);
+    uint8_t bottom = graph_y(b.level_min, level_max);
+    if (bucket > 0 && history_get(h, (uint32_t)bucket - 1, &prev))
+    {
+        uint8_t prev_top = graph_y(prev.level_max, level_max);
+        uint8_t prev_bottom = graph_y(prev.level_min, level_max);
+        bottom = bottom < prev_top ? prev_top : bottom;
+        top = top > prev_bottom ? prev_bottom : top;
+    }
+    ssd1306_vline(d->ssd, x, top, bottom, true);
+
+    if (b.rain_max > 0)
+    {
+        ssd1306_pixel(d->ssd, x, graph_y(b.rain_max, s->rain_max * 10.0f), true);
+    }
+}
+
+/**
+ * @brief Atualiza a área do gráfico com o histórico
+ *
+ * Com o histórico avançando n intervalos desde o último desenho, as colunas
+ * existentes são deslocadas n posições para a esquerda e apenas as colunas da
+ * direita são desenhadas. Sem avanço, apenas a última coluna (intervalo atual)
+ * é redesenhada.
+ */
+static void update_graph(display_t *d, const history_t *h)
+{
+    const chart_scale_t *scale = &d->info.scale;
+    uint8_t from;
+
+    if (!h->started)
+    {
+        return;
+    }
+
+    uint32_t steps = h->last_bucket - d->graph_bucket;
+    if (!d->graph_valid || steps >= WIDTH || memcmp(scale, &d->graph_scale, sizeof(*scale)) != 0)
+    {
+        d->graph_scale = *scale;
+        from = 0;
+    }else {
+        if (steps > 0)
+        {
+            ssd1306_scroll_left(d->ssd, 0, WIDTH - 1, GRAPH_PAGE, LAST_PAGE, steps);
+        }
+        // A coluna que era a atual também pode ter recebido leituras desde o último desenho
+        from = WIDTH - 1 - steps;
+    }
+
+    for (uint8_t x = from; x < WIDTH; x++)
+    {
+        draw_column(d, h, x, (int64_t)h->last_bucket - (WIDTH - 1 - x));
+    }
+
+    d->graph_valid = true;
+    d->graph_bucket = h->last_bucket;
+    d->graph_from = steps ? 0 : from; // Com deslocamento, toda a área mudou
+}
+
+static void render_status(display_t *d)
+{
+    const display_info_t *in = &d->info;
+    char text[24];
+
+    set_row(d, 0, in->status ? in->status : "", true);
+
+    snprintf(text, sizeof(text), "NIVEL %.2fM", in->level);
+    set_row(d, 2, text, false);
+    snprintf(text, sizeof(text), "CHUVA %.0f%%", in->rain);
+    set_row(d, 3, text, false);
+    snprintf(text, sizeof(text), "TEND %+.2fM/H", in->trend);
+    set_row(d, 4, text, false);
+
+    //Exibe o próximo limite que será atingido caso o rio continue subindo
+    text[0] = '\0';
+    if (in->next_name && in->next_eta > 0)
+    {
+        snprintf(text, sizeof(text), "%s %ldMIN", in->next_name, (long)((in->next_eta + 59) / 60));
+    }
+    set_row(d, 6, text, false);
+}
+
+static void render_graph(display_t *d, const history_t *h)
+{
+    char text[24];
+
+    snprintf(text, sizeof(text), "N%.2f C%.0f%%", d->info.level, d->info.rain);
+    set_row(d, 0, text, false);
+    update_graph(d, h);
+}
+
+static void render_network(display_t *d)
+{
+    const display_info_t *in = &d->info;
+    char text[24];
+
+    set_row(d, 0, in->ip[0] ? in->ip : "SEM CONEXAO", false);
+
+    if (in->rssi)
+    {
+        snprintf(text, sizeof(text), "RSSI %ldDBM", (long)in->rssi);
+    }else {
+        snprintf(text, sizeof(text), "RSSI --");
+    }
+    set_row(d, 1, text, false);
+
+    if (in->stations)
+    {
+        snprintf(text, sizeof(text), "GATEWAY %u EST", in->stations);
+    }else {
+        snprintf(text, sizeof(text), "ESTACAO %u", in->station);
+    }
+    set_row(d, 2, text, false);
+
+    snprintf(text, sizeof(text), "RITMO %s", sched_mode_names[in->sched_mode % 3]);
+    set_row(d, 3, text, false);
+    snprintf(text, sizeof(text), "DESCARTES %lu", (unsigned long)in->frames_dropped);
+    set_row(d, 4, text, false);
+    snprintf(text, sizeof(text), "CONFIG V%lu", (unsigned long)in->config_version);
+    set_row(d, 5, text, false);
+    snprintf(text, sizeof(text), "ATIVO %luH%02luM",
+             (unsigned long)(in->uptime_s / 3600), (unsigned long)(in->uptime_s / 60 % 60));
+    set_row(d, 6, text, false);
+}
+
+/**
+ * @brief Envia ao display as áreas alteradas
+ */
+static void flush(display_t *d)
+{
+    if (d->full)
+    {
+        ssd1306_send_data(d->ssd);
+    }else {
+        for (uint8_t page = 0; page <= LAST_PAGE; page++)
+        {
+            if (d->dirty_pages & (1u << page))
+            {
+                ssd1306_send_area(d->ssd, 0, WIDTH - 1, page, page);
+            }
+        }
+        if (d->graph_from < WIDTH)
+        {
+            ssd1306_send_area(d->ssd, d->graph_from, WIDTH - 1, GRAPH_PAGE, LAST_PAGE);
+        }
+    }
+
+    d->full = false;
+    d->dirty_pages = 0;
+    d->graph_from = WIDTH;
+}
+
+/**
+ * @brief Atualiza a tela atual com novas informações, enviando apenas o que mudou
+ */
+void display_update(display_t *d, const display_info_t *info, const history_t *h)
+{
+    d->info = *info;
+
+    switch (d->screen)
+    {
+    case DISPLAY_GRAPH:
+        render_graph(d, h);
+        break;
+    case DISPLAY_NETWORK:
+        render_network(d);
+        break;
+    default:
+        render_status(d);
+        break;
+    }
+    flush(d);
+}
+
+/**
+ * @brief Passa para a próxima tela, que é desenhada por completo no próximo display_update()
+ */
+void display_next_screen(display_t *d)
+{
+    d->screen = (d->screen + 1) % DISPLAY_SCREENS;
+
+    ssd1306_fill(d->ssd, false);
+    memset(d->rows, 0, sizeof(d->rows));
+    d->graph_valid = false;
+    d->full = true;
+}
@@ -0,0 +1,65 @@
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssd1306.h"
+#include "history.h"
+#include "chart.h"
+
+/**
+ * @brief Interface do display com várias telas, alternadas pelo botão A
+ *
+ * As telas são compostas por linhas de texto (uma página de 8 pixels cada) e,
+ * na tela do gráfico, por uma área com o nível e a chuva das últimas horas.
+ * Só é redesenhado e enviado ao display o que mudou: linhas de texto iguais às
+ * exibidas são ignoradas e o gráfico avança deslocando as colunas já
+ * desenhadas, desenhando apenas as colunas novas.
+ */
+typedef enum {
+    DISPLAY_STATUS,     // Status, nível, chuva, tendência e previsão
+    DISPLAY_GRAPH,      // Gráfico do nível e da chuva (uma coluna por intervalo do histórico)
+    DISPLAY_NETWORK,    // Rede e diagnóstico
+    DISPLAY_SCREENS
+} display_screen_t;
+
+/**
+ * @brief Informações exibidas nas telas, preenchidas a cada leitura
+ */
+typedef struct {
+    const char *status;      // Nome do status atual
+    float level;             // m
+    float rain;              // %
+    float trend;             // m/h
+    const char *next_name;   // Próximo limite a ser atingido (NULL se nenhum)
+    int32_t next_eta;        // s até o próximo limite (TREND_NO_ETA se não há previsão)
+    chart_scale_t scale;     // Escala do gráfico (a mesma da página web)
+
+    char ip[16];             // Endereço IP (vazio sem conexão)
+    int32_t rssi;            // dBm (0 se indisponível)
+    uint16_t station;        // ID desta estação
+    uint8_t stations;        // Estações acompanhadas (apenas no modo gateway)
+    uint8_t sched_mode;      // Ritmo do escalonador (sched_mode_t)
+    uint32_t frames_dropped; // Relatórios descartados na UART
+    uint32_t config_version;
+    uint32_t uptime_s;
+} display_info_t;
+
+typedef struct {
+    ssd1306_t *ssd;
+    display_screen_t screen;
+    display_info_t info;         // Informações exibidas
+    char rows[HEIGHT / 8][16];   // Texto exibido em cada página
+    uint8_t dirty_pages;         // Páginas de texto a enviar (um bit por página)
+    bool full;                   // Tela inteira a enviar
+    bool graph_valid;            // Gráfico desenhado e coerente com graph_bucket/graph_scale
+    uint32_t graph_bucket;       // Intervalo do histórico exibido na coluna mais à direita
+    chart_scale_t graph_scale;
+    int16_t graph_from;          // Primeira coluna do gráfico a enviar (WIDTH se nenhuma)
+} display_t;
+
+void display_init(display_t *d, ssd1306_t *ssd);
+void display_update(display_t *d, const display_info_t *info, const history_t *h);
+void display_next_screen(display_t *d);
+
+#endif /* DISPLAY_H */
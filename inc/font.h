@@ -1,5 +1,5 @@
 
-// Fontes para A-Z e 0-9. Os caracteres tem 8x8 pixels
+// Fontes para A-Z, a-z, 0-9 e os símbolos . : - + % /. Os caracteres tem 8x8 pixels
 
 
 static uint8_t font[] = {
@@ -65,5 +65,11 @@ static uint8_t font[] = {
 0x00, 0x04, 0x18, 0x20, 0x10, 0x20, 0x18, 0x04, //w
 0x00, 0x44, 0x28, 0x10, 0x28, 0x44, 0x00, 0x00, //x
 0x00, 0x40, 0x40, 0x22, 0x14, 0x08, 0x04, 0x02, //y
-0x00, 0x62, 0x72, 0x5a, 0x4a, 0x46, 0x46, 0x00  //z
+0x00, 0x62, 0x72, 0x5a, 0x4a, 0x46, 0x46, 0x00, //z
+0x00, 0x00, 0x60, 0x60, 0x00, 0x00, 0x00, 0x00, //.
+0x00, 0x00, 0x36, 0x36, 0x00, 0x00, 0x00, 0x00, //:
+0x00, 0x08, 0x08, 0x08, 0x08, 0x08, 0x00, 0x00, //-
+0x00, 0x08, 0x08, 0x3e, 0x08, 0x08, 0x00, 0x00, //+
+0x00, 0x23, 0x13, 0x08, 0x64, 0x62, 0x00, 0x00, //%
+0x00, 0x20, 0x10, 0x08, 0x04, 0x02, 0x00, 0x00  ///
 };
@@ -0,0 +1,606 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "gateway.h"
+
+/**
+ * @brief Coeficiente mínimo para considerar que a onda de cheia foi identificada
+ */
+#define GATEWAY_MIN_CORRELATION 0.5f
+
+/**
+ * @brief Maior variação (cm) entre slots considerada na correlação
+ */
+#define GATEWAY_MAX_STEP_CM 1000
+
+enum render_stage {
+    RENDER_HEADER,
+    RENDER_STATION_HEADER,
+    RENDER_STATIONS,
+    RENDER_CORRELATION_HEADER,
+    RENDER_CORRELATIONS,
+    RENDER_FOOTER,
+    RENDER_DONE
+};
+
+const char *const gateway_status_names[] = {"SEGURO", "ATENCAO", "ALERTA", "PERIGO"};
+
+#define STATUS_COUNT (sizeof(gateway_status_names) / sizeof(gateway_status_names[0]))
+
+/**
+ * @brief Inicializa o gateway sem nenhuma estação
+ */
+void gateway_init(gateway_t *gw, uint32_t slot_ms)
+{
+    memset(gw, 0, sizeof(*gw));
+    gw->slot_ms = slot_ms ? slot_ms : GATEWAY_SLOT_MS;
+}
+
+/**
+ * @brief Retorna o índice do status em gateway_status_names, ou -1 se desconhecido
+ */
+int gateway_status_index(const char *name)
+{
+    for (size_t i = 0; i < STATUS_COUNT; i++)
+    {
+        if (strcmp(name, gateway_status_names[i]) == 0)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+static uint8_t checksum(const char *data, size_t len)
+{
+    uint8_t ck = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        ck ^= (uint8_t)data[i];
+    }
+    return ck;
+}
+
+/**
+ * @brief Formata um relatório para envio ao gateway
+ *
+ * Retorna o tamanho do texto gerado, ou 0 se não couber em buf.
+ */
+size_t gateway_format_report(char *buf, size_t size, const gateway_report_t *r)
+{
+    const char *status = r->status < STATUS_COUNT ? gateway_status_names[r->status] : "ERRO";
+
+    int n = snprintf(buf, size, "G,%u,%lu,%.2f,%.2f,%s,%.3f",
+                     r->station, (unsigned long)r->report_id, r->level, r->rain, status, r->trend);
+    if (n < 0 || (size_t)n >= size)
+    {
+        return 0;
+    }
+
+    int m = snprintf(buf + n, size - n, "*%02X\n", checksum(buf, n));
+    if (m < 0 || (size_t)m >= size - n)
+    {
+        return 0;
+    }
+
+    return n + m;
+}
+
+/**
+ * @brief Lê um inteiro sem sinal terminado por ',' ou '*'
+ *
+ * A leitura é feita manualmente (sem strtoul/strtof) para não depender de
+ * funções da libc que alocam memória.
+ */
+static bool parse_uint(const char **p, const char *end, uint32_t *out)
+{
+    const char *s = *p;
+    uint32_t value = 0;
+
+    if (s >= end || *s < '0' || *s > '9')
+    {
+        return false;
+    }
+    while (s < end && *s >= '0' && *s <= '9')
+    {
+        if (value > (UINT32_MAX - 9) / 10)
+        {
+            return false; // Valor fora da faixa: rejeitado antes de estourar
+        }
+        value = value * 10 + (*s - '0');
+        s++;
+    }
+
+    *p = s;
+    *out = value;
+    return true;
+}
+
+/**
+ * @brief Lê um número decimal com sinal opcional e até 6 casas decimais
+ */
+static bool parse_decimal(const char **p, const char *end, float *out)
+{
+    const char *s = *p;
+    bool negative = false;
+    uint32_t integer = 0;
+    uint32_t fraction = 0;
+    uint32_t scale = 1;
+
+    if (s < end && (*s == '-' || *s == '+'))
+    {
+        negative = (*s == '-');
+        s++;
+    }
+    if (!parse_uint(&s, end, &integer))
+    {
+        return false;
+    }
+    if (s < end && *s == '.')
+    {
+        s++;
+        while (s < end && *s >= '0' && *s <= '9')
+        {
+            if (scale < 1000000)
+            {
+                fraction = fraction * 10 + (*s - '0');
+                scale *= 10;
+            }
+            s++;
+        }
+    }
+
+    float value = integer + (float)fraction / scale;
+    *out = negative ? -value : value;
+    *p = s;
+    return true;
+}
+
+static bool expect(const char **p, const char *end, char c)
+{
+    if (*p >= end || **p != c)
+    {
+        return false;
+    }
+    (*p)++;
+    return true;
+}
+
+/**
+ * @brief Interpreta um relatório recebido pelo gateway, validando o checksum
+ */
+bool gateway_parse_report(const char *line, size_t len, gateway_report_t *r)
+{
+    const char *end = line + len;
+    const char *p = line;
+    const char *star = memchr(line, '*', len);
+    uint32_t value;
+
+    if (!star || end - star < 3)
+    {
+        return false;
+    }
+
+    // Checksum em hexadecimal logo após o '*'
+    uint8_t expected = 0;
+    for (int i = 1; i <= 2; i++)
+    {
+        char c = star[i];
+        expected <<= 4;
+        if (c >= '0' && c <= '9') expected |= c - '0';
+        else if (c >= 'A' && c <= 'F') expected |= c - 'A' + 10;
+        else if (c >= 'a' && c <= 'f') expected |= c - 'a' + 10;
+        else return false;
+    }
+    if (checksum(line, star - line) != expected)
+    {
+        return false;
+    }
+
+    end = star;
+    if (!expect(&p, end, 'G') || !expect(&p, end, ','))
+    {
+        return false;
+    }
+
+    if (!parse_uint(&p, end, &value) || value > UINT16_MAX || !expect(&p, end, ','))
+    {
+        return false;
+    }
+    r->station = (uint16_t)value;
+
+    if (!parse_uint(&p, end, &r->report_id) || !expect(&p, end, ','))
+    {
+        return false;
+    }
+    if (!parse_decimal(&p, end, &r->level) || !expect(&p, end, ','))
+    {
+        return false;
+    }
+    if (!parse_decimal(&p, end, &r->rain) || !expect(&p, end, ','))
+    {
+        return false;
+    }
+
+    const char *comma = memchr(p, ',', end - p);
+    char status[12];
+    if (!comma || (size_t)(comma - p) >= sizeof(status))
+    {
+        return false;
+    }
+    memcpy(status, p, comma - p);
+    status[comma - p] = '\0';
+    int index = gateway_status_index(status);
+    if (index < 0)
+    {
+        return false;
+    }
+    r->status = (uint8_t)index;
+    p = comma + 1;
+
+    if (!parse_decimal(&p, end, &r->trend))
+    {
+        return false;
+    }
+
+    return p == end;
+}
+
+/**
+ * @brief Retorna a estação com o ID informado, incluindo-a se necessário
+ *
+ * As estações são mantidas ordenadas por ID. Se não houver espaço, a estação
+ * há mais tempo sem relatórios é substituída, desde que esteja inativa há
+ * mais de GATEWAY_STALE_MS.
+ */
+static gateway_station_t *find_or_add(gateway_t *gw, uint16_t station, uint32_t now_ms, bool *added)
+{
+    uint8_t pos = 0;
+    while (pos < gw->count && gw->stations[pos].station < station)
+    {
+        pos++;
+    }
+
+    *added = false;
+    if (pos < gw->count && gw->stations[pos].station == station)
+    {
+        return &gw->stations[pos];
+    }
+
+    if (gw->count == GATEWAY_MAX_STATIONS)
+    {
+        uint8_t stalest = 0;
+        for (uint8_t i = 1; i < gw->count; i++)
+        {
+            if (now_ms - gw->stations[i].last_seen_ms > now_ms - gw->stations[stalest].last_seen_ms)
+            {
+                stalest = i;
+            }
+        }
+        if (now_ms - gw->stations[stalest].last_seen_ms < GATEWAY_STALE_MS)
+        {
+            return NULL;
+        }
+
+        memmove(&gw->stations[stalest], &gw->stations[stalest + 1],
+                (gw->count - stalest - 1) * sizeof(gateway_station_t));
+        gw->count--;
+        if (stalest < pos)
+        {
+            pos--;
+        }
+    }
+
+    memmove(&gw->stations[pos + 1], &gw->stations[pos], (gw->count - pos) * sizeof(gateway_station_t));
+    gw->count++;
+
+    gateway_station_t *st = &gw->stations[pos];
+    memset(st, 0, sizeof(*st));
+    st->station = station;
+    for (size_t i = 0; i < GATEWAY_HISTORY; i++)
+    {
+        st->level_cm[i] = GATEWAY_NO_DATA;
+    }
+
+    *added = true;
+    return st;
+}
+
+/**
+ * @brief Registra um relatório recebido no instante now_ms
+ *
+ * O nível é guardado no slot correspondente ao instante de recepção. Slots
+ * sem relatórios entre duas amostras são interpolados quando o intervalo é
+ * curto (até GATEWAY_MAX_GAP slots) e marcados como ausentes caso contrário.
+ */
+bool gateway_ingest(gateway_t *gw, const gateway_report_t *r, uint32_t now_ms)
+{
+    bool added;
+    gateway_station_t *st = find_or_add(gw, r->station, now_ms, &added);
+    if (!st)
+    {
+        gw->dropped++;
+        return false;
+    }
+
+    uint32_t slot = now_ms / gw->slot_ms;
+    float level_cm = r->level * 100.0f;
+    int16_t cm = (int16_t)(level_cm > 32000.0f ? 32000 : (level_cm < -32000.0f ? -32000 : level_cm + 0.5f));
+
+    if (added)
+    {
+        st->last_slot = slot;
+    }else if (slot > st->last_slot){
+        uint32_t gap = slot - st->last_slot;
+        int16_t prev = st->level_cm[st->last_slot % GATEWAY_HISTORY];
+        uint32_t steps = gap < GATEWAY_HISTORY ? gap : GATEWAY_HISTORY;
+
+        for (uint32_t k = gap - steps + 1; k < gap; k++)
+        {
+            int16_t value = GATEWAY_NO_DATA;
+            if (gap <= GATEWAY_MAX_GAP && prev != GATEWAY_NO_DATA)
+            {
+                value = prev + (int32_t)(cm - prev) * (int32_t)k / (int32_t)gap;
+            }
+            st->level_cm[(st->last_slot + k) % GATEWAY_HISTORY] = value;
+        }
+        st->last_slot = slot;
+    }
+
+    // Relatórios fora de ordem (slot anterior ao último) atualizam o slot mais recente
+    st->level_cm[st->last_slot % GATEWAY_HISTORY] = cm;
+    st->station = r->station;
+    st->report_id = r->report_id;
+    st->status = r->status;
+    st->level = r->level;
+    st->rain = r->rain;
+    st->trend = r->trend;
+    st->last_seen_ms = now_ms;
+
+    gw->received++;
+    return true;
+}
+
+/**
+ * @brief Nível (cm) da estação no slot absoluto informado, ou GATEWAY_NO_DATA
+ */
+static int16_t sample_at(const gateway_station_t *st, int64_t slot)
+{
+    if (slot < 0 || slot > st->last_slot || slot <= (int64_t)st->last_slot - GATEWAY_HISTORY)
+    {
+        return GATEWAY_NO_DATA;
+    }
+    return st->level_cm[slot % GATEWAY_HISTORY];
+}
+
+/**
+ * @brief Variação do nível entre o slot anterior e o slot informado
+ */
+static bool step_at(const gateway_station_t *st, int64_t slot, int32_t *step)
+{
+    int16_t curr = sample_at(st, slot);
+    int16_t prev = sample_at(st, slot - 1);
+    if (curr == GATEWAY_NO_DATA || prev == GATEWAY_NO_DATA)
+    {
+        return false;
+    }
+
+    int32_t d = curr - prev;
+    if (d > GATEWAY_MAX_STEP_CM) d = GATEWAY_MAX_STEP_CM;
+    if (d < -GATEWAY_MAX_STEP_CM) d = -GATEWAY_MAX_STEP_CM;
+    *step = d;
+    return true;
+}
+
+/**
+ * @brief Estima o atraso da onda de cheia entre uma estação e a seguinte
+ *
+ * Procura o atraso (0 a GATEWAY_MAX_LAG slots) que maximiza a correlação de
+ * Pearson entre as variações do nível a montante e as variações a jusante.
+ * Usar as variações, e não o nível, elimina a diferença de nível base entre
+ * trechos do rio. Os somatórios são inteiros, para manter o custo baixo no
+ * RP2040 (sem FPU).
+ */
+bool gateway_correlate(const gateway_station_t *up, const gateway_station_t *down,
+                       gateway_correlation_t *out)
+{
+    int64_t end = up->last_slot < down->last_slot ? up->last_slot : down->last_slot;
+    float best = -2.0f;
+    int16_t best_lag = 0;
+
+    out->valid = false;
+    out->lag_slots = 0;
+    out->coefficient = 0.0f;
+
+    for (int16_t lag = 0; lag <= GATEWAY_MAX_LAG; lag++)
+    {
+        int32_t n = 0, sx = 0, sy = 0, sxx = 0, syy = 0, sxy = 0;
+
+        for (int64_t s = end; s > end - GATEWAY_HISTORY; s--)
+        {
+            int32_t x, y;
+            if (!step_at(down, s, &y) || !step_at(up, s - lag, &x))
+            {
+                continue;
+            }
+            n++;
+            sx += x;
+            sy += y;
+            sxx += x * x;
+            syy += y * y;
+            sxy += x * y;
+        }
+
+        if (n < GATEWAY_MIN_OVERLAP)
+        {
+            continue;
+        }
+
+        int64_t num = (int64_t)n * sxy - (int64_t)sx * sy;
+        int64_t var_x = (int64_t)n * sxx - (int64_t)sx * sx;
+        int64_t var_y = (int64_t)n * syy - (int64_t)sy * sy;
+        if (var_x <= 0 || var_y <= 0)
+        {
+            continue;
+        }
+
+        float r = (float)num / sqrtf((float)var_x * (float)var_y);
+        if (r > best)
+        {
+            best = r;
+            best_lag = lag;
+        }
+    }
+
+    if (best < -1.5f)
+    {
+        return false;
+    }
+
+    out->lag_slots = best_lag;
+    out->coefficient = best;
+    out->valid = best >= GATEWAY_MIN_CORRELATION;
+    return out->valid;
+}
+
+/**
+ * @brief Reinicia a geração da página consolidada
+ */
+void gateway_cursor_init(gateway_cursor_t *cur)
+{
+    cur->stage = RENDER_HEADER;
+    cur->index = 0;
+}
+
+bool gateway_render_done(const gateway_cursor_t *cur)
+{
+    return cur->stage == RENDER_DONE;
+}
+
+/**
+ * @brief Gera o próximo trecho da página consolidada (HTML)
+ *
+ * Cada chamada escreve em buf um trecho completo (cabeçalho, uma linha de
+ * tabela, ...) e avança o cursor, permitindo enviar a página aos poucos sem
+ * um buffer do tamanho da página inteira. Retorna 0 quando a página terminou
+ * ou quando o trecho não cabe em buf (o cursor não avança nesse caso; um buf
+ * de 512 bytes é suficiente para qualquer trecho).
+ */
+size_t gateway_render(const gateway_t *gw, gateway_cursor_t *cur, char *buf, size_t size, uint32_t now_ms)
+{
+    int n = 0;
+
+    // Estações podem ser incluídas/substituídas entre duas chamadas
+    if ((cur->stage == RENDER_STATIONS && cur->index >= gw->count) ||
+        (cur->stage == RENDER_CORRELATIONS && cur->index + 1 >= gw->count))
+    {
+        cur->index = 0;
+        cur->stage++;
+    }
+
+    switch (cur->stage)
+    {
+    case RENDER_HEADER:
+        n = snprintf(buf, size,
+            "<!DOCTYPE html>\n"
+            "<html>\n"
+            "<head>\n"
+            "<meta charset=\"utf-8\">\n"
+            "<meta http-equiv=\"refresh\" content=\"30\">\n"
+            "<title> Monitoramento de Rios - Gateway </title>\n"
+            "<style>body { background-color: #b5e5fb; font-family: Arial, sans-serif; }"
+            " td, th { padding: 4px 10px; text-align: center; }</style>\n"
+            "</head>\n"
+            "<body>\n"
+            "<h1>Monitoramento de Rios - Gateway</h1>\n"
+            "<p>Relatorios: %lu aceitos, %lu invalidos, %lu descartados</p>\n",
+            (unsigned long)gw->received, (unsigned long)gw->rejected, (unsigned long)gw->dropped);
+        break;
+
+    case RENDER_STATION_HEADER:
+        n = snprintf(buf, size,
+            "<table>\n"
+            "<tr><th>Estacao</th><th>Nivel (m)</th><th>Chuva (%%)</th><th>Tendencia (m/h)</th>"
+            "<th>Status</th><th>Ultimo relatorio (s)</th></tr>\n");
+        break;
+
+    case RENDER_STATIONS:
+    {
+        const gateway_station_t *st = &gw->stations[cur->index];
+        n = snprintf(buf, size,
+            "<tr><td>%u</td><td>%.2f</td><td>%.1f</td><td>%+.2f</td><td>%s</td><td>%lu</td></tr>\n",
+            st->station, st->level, st->rain, st->trend, gateway_status_names[st->status % STATUS_COUNT],
+            (unsigned long)((now_ms - st->last_seen_ms) / 1000));
+        break;
+    }
+
+    case RENDER_CORRELATION_HEADER:
+        n = snprintf(buf, size,
+            "</table>\n"
+            "<h2>Propagacao da cheia</h2>\n"
+            "<table>\n"
+            "<tr><th>Montante</th><th>Jusante</th><th>Atraso (s)</th><th>Correlacao</th></tr>\n");
+        break;
+
+    case RENDER_CORRELATIONS:
+    {
+        const gateway_station_t *up = &gw->stations[cur->index];
+        const gateway_station_t *down = &gw->stations[cur->index + 1];
+        gateway_correlation_t c;
+
+        if (gateway_correlate(up, down, &c))
+        {
+            n = snprintf(buf, size, "<tr><td>%u</td><td>%u</td><td>%.1f</td><td>%.2f</td></tr>\n",
+                         up->station, down->station, c.lag_slots * (gw->slot_ms / 1000.0f), c.coefficient);
+        }else {
+            n = snprintf(buf, size, "<tr><td>%u</td><td>%u</td><td>--</td><td>--</td></tr>\n",
+                         up->station, down->station);
+        }
+        break;
+    }
+
+    case RENDER_FOOTER:
+        n = snprintf(buf, size, "</table>\n</body>\n</html>\n");
+        break;
+
+    default:
+        return 0;
+    }
+
+    if (n < 0 || (size_t)n >= size)
+    {
+        return 0;
+    }
+
+    // Avança para o próximo trecho
+    switch (cur->stage)
+    {
+    case RENDER_STATIONS:
+        if (++cur->index < gw->count)
+        {
+            break;
+        }
+        cur->index = 0;
+        cur->stage = RENDER_CORRELATION_HEADER;
+        break;
+    case RENDER_CORRELATIONS:
+        if (++cur->index + 1 < gw->count)
+        {
+            break;
+        }
+        cur->index = 0;
+        cur->stage = RENDER_FOOTER;
+        break;
+    case RENDER_STATION_HEADER:
+        cur->stage = gw->count ? RENDER_STATIONS : RENDER_CORRELATION_HEADER;
+        break;
+    case RENDER_CORRELATION_HEADER:
+        cur->stage = gw->count > 1 ? RENDER_CORRELATIONS : RENDER_FOOTER;
+        break;
+    default:
+        cur->stage++;
+        break;
+    }
+
+    return n;
+}
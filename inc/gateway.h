@@ -0,0 +1,140 @@
+#ifndef GATEWAY_H
+#define GATEWAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Agregação de relatórios de várias estações de monitoramento
+ *
+ * O gateway recebe os relatórios das estações (um datagrama UDP por relatório),
+ * guarda o nível de cada estação em um histórico indexado pelo tempo de
+ * recepção e gera uma visão consolidada, incluindo o atraso estimado da onda
+ * de cheia entre estações vizinhas.
+ *
+ * Convenção: os IDs das estações crescem no sentido da correnteza, isto é,
+ * a estação N está a montante da estação N + 1.
+ *
+ * Toda a memória é fixa (GATEWAY_MAX_STATIONS x GATEWAY_HISTORY) e o módulo
+ * não depende do SDK, podendo ser compilado também para o host (ver host/).
+ */
+
+/**
+ * @brief Quantidade máxima de estações acompanhadas
+ */
+#ifndef GATEWAY_MAX_STATIONS
+#define GATEWAY_MAX_STATIONS 32
+#endif
+
+/**
+ * @brief Quantidade de intervalos (slots) guardados no histórico de cada estação
+ */
+#ifndef GATEWAY_HISTORY
+#define GATEWAY_HISTORY 128
+#endif
+
+/**
+ * @brief Duração padrão (ms) de cada slot do histórico
+ */
+#define GATEWAY_SLOT_MS 60000
+
+/**
+ * @brief Maior atraso (em slots) considerado na correlação entre estações
+ */
+#define GATEWAY_MAX_LAG 60
+
+/**
+ * @brief Quantidade mínima de pares de amostras para aceitar uma correlação
+ */
+#define GATEWAY_MIN_OVERLAP 16
+
+/**
+ * @brief Maior intervalo (em slots) sem relatórios que ainda é interpolado
+ */
+#define GATEWAY_MAX_GAP 10
+
+/**
+ * @brief Tempo (ms) sem relatórios a partir do qual uma estação pode ser substituída
+ */
+#define GATEWAY_STALE_MS (30 * 60 * 1000)
+
+/**
+ * @brief Porta UDP em que o gateway recebe os relatórios
+ */
+#define GATEWAY_PORT 5005
+
+/**
+ * @brief Tamanho máximo de um relatório no formato do gateway
+ */
+#define GATEWAY_REPORT_MAX 96
+
+#define GATEWAY_NO_DATA INT16_MIN
+
+/**
+ * @brief Relatório de uma estação, como enviado ao gateway
+ *
+ * Formato do datagrama: G,estacao,id,nivel,chuva,status,tendencia*CK
+ */
+typedef struct {
+    uint16_t station;
+    uint32_t report_id;
+    float level;        // m
+    float rain;         // %
+    float trend;        // m/h
+    uint8_t status;     // Índice em gateway_status_names
+} gateway_report_t;
+
+typedef struct {
+    uint16_t station;
+    uint8_t status;
+    uint32_t report_id;
+    uint32_t last_seen_ms;
+    float level;
+    float rain;
+    float trend;
+    uint32_t last_slot;                   // Slot absoluto da amostra mais recente
+    int16_t level_cm[GATEWAY_HISTORY];    // Nível (cm) por slot, GATEWAY_NO_DATA se ausente
+} gateway_station_t;
+
+typedef struct {
+    uint32_t slot_ms;
+    uint32_t received;   // Relatórios aceitos
+    uint32_t rejected;   // Datagramas com formato inválido
+    uint32_t dropped;    // Relatórios descartados por falta de espaço
+    uint8_t count;       // Estações em uso (ordenadas por ID)
+    gateway_station_t stations[GATEWAY_MAX_STATIONS];
+} gateway_t;
+
+/**
+ * @brief Resultado da correlação entre uma estação e a seguinte (a jusante)
+ */
+typedef struct {
+    bool valid;
+    int16_t lag_slots;   // Atraso da onda entre as estações
+    float coefficient;   // Coeficiente de correlação (Pearson) no atraso encontrado
+} gateway_correlation_t;
+
+/**
+ * @brief Posição da geração incremental da página consolidada
+ */
+typedef struct {
+    uint8_t stage;
+    uint8_t index;
+} gateway_cursor_t;
+
+extern const char *const gateway_status_names[];
+
+void gateway_init(gateway_t *gw, uint32_t slot_ms);
+size_t gateway_format_report(char *buf, size_t size, const gateway_report_t *r);
+bool gateway_parse_report(const char *line, size_t len, gateway_report_t *r);
+int gateway_status_index(const char *name);
+bool gateway_ingest(gateway_t *gw, const gateway_report_t *r, uint32_t now_ms);
+bool gateway_correlate(const gateway_station_t *up, const gateway_station_t *down,
+                       gateway_correlation_t *out);
+
+void gateway_cursor_init(gateway_cursor_t *cur);
+bool gateway_render_done(const gateway_cursor_t *cur);
+size_t gateway_render(const gateway_t *gw, gateway_cursor_t *cur, char *buf, size_t size, uint32_t now_ms);
+
+#endif /* GATEWAY_H */
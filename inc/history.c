@@ -0,0 +1,113 @@
+#include <string.h>
+#include "history.h"
+
+static int16_t to_fixed(float value, float scale)
+{
+    float v = value * scale;
+    if (v > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    if (v <= HISTORY_NO_DATA)
+    {
+        return HISTORY_NO_DATA + 1;
+    }
+    return (int16_t)(v + (v >= 0 ? 0.5f : -0.5f));
+}
+
+static void clear_bucket(history_bucket_t *b)
+{
+    b->level_min = HISTORY_NO_DATA;
+    b->level_max = HISTORY_NO_DATA;
+    b->rain_min = HISTORY_NO_DATA;
+    b->rain_max = HISTORY_NO_DATA;
+}
+
+/**
+ * @brief Inicializa o histórico vazio
+ */
+void history_init(history_t *h, uint32_t bucket_ms)
+{
+    memset(h, 0, sizeof(*h));
+    h->bucket_ms = bucket_ms ? bucket_ms : HISTORY_BUCKET_MS;
+    for (uint32_t i = 0; i < HISTORY_BUCKETS; i++)
+    {
+        clear_bucket(&h->buckets[i]);
+    }
+}
+
+/**
+ * @brief Registra uma leitura (nível em m, chuva em %) no intervalo atual
+ *
+ * Retorna true quando a leitura iniciou um novo intervalo (inclusive a
+ * primeira leitura), isto é, quando o histórico avançou.
+ */
+bool history_add(history_t *h, float level, float rain, uint32_t now_ms)
+{
+    bool advanced = false;
+
+    if (!h->started)
+    {
+        h->started = true;
+        h->start_ms = now_ms;
+        advanced = true;
+    }else {
+        // Subtração sem sinal: continua correta quando o contador de ms dá a volta
+        uint32_t steps = (now_ms - h->start_ms) / h->bucket_ms;
+        if (steps)
+        {
+            // Intervalos pulados (sem leituras) ficam vazios
+            uint32_t clear = steps < HISTORY_BUCKETS ? steps : HISTORY_BUCKETS;
+            for (uint32_t i = 1; i <= clear; i++)
+            {
+                clear_bucket(&h->buckets[(h->last_bucket + i) % HISTORY_BUCKETS]);
+            }
+            h->last_bucket += steps;
+            h->start_ms += steps * h->bucket_ms;
+            advanced = true;
+        }
+    }
+
+    history_bucket_t *b = &h->buckets[h->last_bucket % HISTORY_BUCKETS];
+    int16_t level_cm = to_fixed(level, 100.0f);
+    int16_t rain_d = to_fixed(rain, 10.0f);
+
+    if (b->level_min == HISTORY_NO_DATA)
+    {
+        b->level_min = b->level_max = level_cm;
+        b->rain_min = b->rain_max = rain_d;
+        return advanced;
+    }
+
+    b->level_min = level_cm < b->level_min ? level_cm : b->level_min;
+    b->level_max = level_cm > b->level_max ? level_cm : b->level_max;
+    b->rain_min = rain_d < b->rain_min ? rain_d : b->rain_min;
+    b->rain_max = rain_d > b->rain_max ? rain_d : b->rain_max;
+    return advanced;
+}
+
+/**
+ * @brief Número do intervalo mais antigo ainda guardado
+ *
+ * Os intervalos válidos vão de history_first_bucket() até h->last_bucket.
+ */
+uint32_t history_first_bucket(const history_t *h)
+{
+    return h->last_bucket >= HISTORY_BUCKETS - 1 ? h->last_bucket - (HISTORY_BUCKETS - 1) : 0;
+}
+
+/**
+ * @brief Lê um intervalo pelo seu número
+ *
+ * Retorna false se o intervalo está fora da janela guardada ou não tem leituras.
+ */
+bool history_get(const history_t *h, uint32_t bucket, history_bucket_t *out)
+{
+    if (!h->started || bucket > h->last_bucket || bucket < history_first_bucket(h))
+    {
+        return false;
+    }
+
+    *out = h->buckets[bucket % HISTORY_BUCKETS];
+    return out->level_min != HISTORY_NO_DATA;
+}
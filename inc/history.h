@@ -0,0 +1,53 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Histórico recente do nível do rio e da intensidade da chuva
+ *
+ * As leituras são agrupadas em intervalos de tempo fixos (buckets) e cada
+ * intervalo guarda apenas o mínimo e o máximo observados, de modo que picos
+ * curtos não se perdem independentemente do ritmo de leitura. O histórico é
+ * um buffer circular de tamanho fixo, indexado pelo número do intervalo
+ * (contado desde a primeira leitura); intervalos sem leituras ficam vazios.
+ *
+ * O módulo não depende do SDK, podendo ser compilado também para o host (ver host/).
+ */
+
+/**
+ * @brief Quantidade de intervalos guardados (com 1 min por intervalo: 6 horas)
+ */
+#ifndef HISTORY_BUCKETS
+#define HISTORY_BUCKETS 360
+#endif
+
+/**
+ * @brief Duração padrão (ms) de cada intervalo do histórico
+ */
+#define HISTORY_BUCKET_MS 60000
+
+#define HISTORY_NO_DATA INT16_MIN
+
+typedef struct {
+    int16_t level_min;   // cm, HISTORY_NO_DATA se o intervalo não tem leituras
+    int16_t level_max;   // cm
+    int16_t rain_min;    // décimos de %
+    int16_t rain_max;    // décimos de %
+} history_bucket_t;
+
+typedef struct {
+    uint32_t bucket_ms;
+    uint32_t last_bucket;   // Número do intervalo mais recente
+    uint32_t start_ms;      // Início do intervalo mais recente
+    bool started;           // Já recebeu alguma leitura
+    history_bucket_t buckets[HISTORY_BUCKETS];
+} history_t;
+
+void history_init(history_t *h, uint32_t bucket_ms);
+bool history_add(history_t *h, float level, float rain, uint32_t now_ms);
+uint32_t history_first_bucket(const history_t *h);
+bool history_get(const history_t *h, uint32_t bucket, history_bucket_t *out);
+
+#endif /* HISTORY_H */
@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <string.h>
+#include "report_uart.h"
+#include "pico/sync.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+#if (REPORT_UART_BUF_SIZE & (REPORT_UART_BUF_SIZE - 1)) != 0
+#error "REPORT_UART_BUF_SIZE deve ser potencia de 2"
+#endif
+
+#define RING_MASK (REPORT_UART_BUF_SIZE - 1)
+
+static uint8_t ring[REPORT_UART_BUF_SIZE];
+static volatile uint32_t head;        // Próxima posição de escrita (cresce indefinidamente)
+static volatile uint32_t tail;        // Próxima posição a ser enviada pelo DMA
+static volatile uint32_t in_flight;   // Bytes da transferência DMA em andamento
+static int dma_chan = -1;
+static critical_section_t ring_lock;
+static report_uart_stats_t stats;
+
+/**
+ * @brief Inicia uma transferência DMA com o próximo trecho contíguo do buffer
+ *
+ * Deve ser chamada com ring_lock adquirido.
+ */
+static void start_transfer(void)
+{
+    if (in_flight || head == tail)
+    {
+        return;
+    }
+
+    uint32_t start = tail & RING_MASK;
+    uint32_t len = head - tail;
+    if (start + len > REPORT_UART_BUF_SIZE)
+    {
+        len = REPORT_UART_BUF_SIZE - start; // Envia até o fim; o restante vai na próxima transferência
+    }
+
+    in_flight = len;
+    dma_channel_transfer_from_buffer_now(dma_chan, &ring[start], len);
+}
+
+/**
+ * @brief Tratamento da interrupção de fim de transferência DMA
+ */
+static void dma_irq_handler(void)
+{
+    if (!dma_channel_get_irq0_status(dma_chan))
+    {
+        return;
+    }
+    dma_channel_acknowledge_irq0(dma_chan);
+
+    critical_section_enter_blocking(&ring_lock);
+    tail += in_flight;
+    in_flight = 0;
+    start_transfer();
+    critical_section_exit(&ring_lock);
+}
+
+/**
+ * @brief Configura a UART e o canal DMA responsável por esvaziar o buffer
+ */
+void report_uart_init(uart_inst_t *uart, uint baud_rate, uint tx_pin, uint rx_pin)
+{
+    uart_init(uart, baud_rate);
+    gpio_set_function(tx_pin, GPIO_FUNC_UART);
+    gpio_set_function(rx_pin, GPIO_FUNC_UART);
+
+    critical_section_init(&ring_lock);
+
+    dma_chan = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, uart_get_dreq(uart, true));
+    dma_channel_configure(dma_chan, &c, &uart_get_hw(uart)->dr, NULL, 0, false);
+
+    dma_channel_set_irq0_enabled(dma_chan, true);
+    irq_add_shared_handler(DMA_IRQ_0, dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+}
+
+/**
+ * @brief Enfileira um relatório completo para envio, sem bloquear
+ *
+ * O relatório é aceito por inteiro ou descartado por inteiro, de forma que
+ * o receptor nunca veja um relatório truncado. Retorna false no descarte.
+ */
+bool report_uart_write(const char *data, size_t len)
+{
+    bool accepted = false;
+
+    critical_section_enter_blocking(&ring_lock);
+    if (len <= REPORT_UART_BUF_SIZE - (head - tail))
+    {
+        uint32_t start = head & RING_MASK;
+        uint32_t first = REPORT_UART_BUF_SIZE - start;
+        if (first > len)
+        {
+            first = len;
+        }
+        memcpy(&ring[start], data, first);
+        memcpy(ring, data + first, len - first);
+
+        head += len;
+        stats.frames_sent++;
+        accepted = true;
+        start_transfer();
+    }else {
+        stats.frames_dropped++;
+        stats.bytes_dropped += len;
+    }
+    critical_section_exit(&ring_lock);
+
+    return accepted;
+}
+
+/**
+ * @brief Acrescenta texto formatado ao relatório em construção
+ *
+ * Retorna false se o texto não couber no espaço restante do relatório.
+ */
+bool report_uart_appendf(char *frame, size_t size, size_t *len, const char *fmt, ...)
+{
+    if (*len >= size)
+    {
+        return false;
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(frame + *len, size - *len, fmt, args);
+    va_end(args);
+
+    if (n < 0 || (size_t)n >= size - *len)
+    {
+        *len = size - 1;
+        return false;
+    }
+
+    *len += n;
+    return true;
+}
+
+/**
+ * @brief Copia os contadores de uso do buffer de saída
+ */
+void report_uart_get_stats(report_uart_stats_t *out)
+{
+    critical_section_enter_blocking(&ring_lock);
+    *out = stats;
+    critical_section_exit(&ring_lock);
+}
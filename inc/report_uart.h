@@ -0,0 +1,47 @@
+#ifndef REPORT_UART_H
+#define REPORT_UART_H
+
+#include <stdarg.h>
+#include "pico/stdlib.h"
+#include "hardware/uart.h"
+
+/**
+ * @brief Tamanho do buffer circular de saída (deve ser potência de 2)
+ */
+#ifndef REPORT_UART_BUF_SIZE
+#define REPORT_UART_BUF_SIZE 2048
+#endif
+
+/**
+ * @brief Tamanho máximo de um relatório formatado
+ */
+#define REPORT_FRAME_MAX 384
+
+/**
+ * @brief Formato dos relatórios enviados pela UART
+ *
+ * REPORT_FORMAT_TEXT: texto legível, uma informação por linha
+ * REPORT_FORMAT_CSV: uma linha por relatório, terminada com checksum (ver README)
+ */
+#define REPORT_FORMAT_TEXT 0
+#define REPORT_FORMAT_CSV 1
+
+#ifndef REPORT_FORMAT
+#define REPORT_FORMAT REPORT_FORMAT_TEXT
+#endif
+
+/**
+ * @brief Contadores de uso do buffer de saída
+ */
+typedef struct {
+    uint32_t frames_sent;      // Relatórios aceitos no buffer
+    uint32_t frames_dropped;   // Relatórios descartados por falta de espaço
+    uint32_t bytes_dropped;    // Bytes descartados por falta de espaço
+} report_uart_stats_t;
+
+void report_uart_init(uart_inst_t *uart, uint baud_rate, uint tx_pin, uint rx_pin);
+bool report_uart_write(const char *data, size_t len);
+bool report_uart_appendf(char *frame, size_t size, size_t *len, const char *fmt, ...);
+void report_uart_get_stats(report_uart_stats_t *stats);
+
+#endif /* REPORT_UART_H */
@@ -0,0 +1,121 @@
+#include "scheduler.h"
+#include "site_config.h"
+
+/**
+ * @brief Preenche a configuração com os valores de site_config.h
+ */
+void scheduler_default_config(scheduler_config_t *config)
+{
+    config->sample_ms[SCHED_SLOW] = SCHED_SLOW_SAMPLE_MS;
+    config->sample_ms[SCHED_NORMAL] = SCHED_NORMAL_SAMPLE_MS;
+    config->sample_ms[SCHED_FAST] = SCHED_FAST_SAMPLE_MS;
+    config->report_ms[SCHED_SLOW] = SCHED_SLOW_REPORT_MS;
+    config->report_ms[SCHED_NORMAL] = SCHED_NORMAL_REPORT_MS;
+    config->report_ms[SCHED_FAST] = SCHED_FAST_REPORT_MS;
+    config->fast_rate = SCHED_FAST_RATE;
+    config->calm_rate = SCHED_CALM_RATE;
+    config->hold_ms = SCHED_HOLD_MS;
+}
+
+/**
+ * @brief Inicia no ritmo rápido, até que a tendência do nível esteja estabelecida
+ */
+void scheduler_init(scheduler_t *s, const scheduler_config_t *config, uint32_t now_ms)
+{
+    s->config = *config;
+    s->mode = SCHED_FAST;
+    s->calming = false;
+    s->calm_since_ms = now_ms;
+    s->next_report_ms = now_ms + config->report_ms[SCHED_FAST];
+}
+
+/**
+ * @brief Garante que o próximo relatório não espere mais que o intervalo do ritmo atual
+ */
+static void limit_next_report(scheduler_t *s, uint32_t now_ms)
+{
+    uint32_t report_ms = s->config.report_ms[s->mode];
+    if ((int32_t)(s->next_report_ms - (now_ms + report_ms)) > 0)
+    {
+        s->next_report_ms = now_ms + report_ms;
+    }
+}
+
+/**
+ * @brief Troca os intervalos em uso, mantendo o ritmo atual
+ */
+void scheduler_set_config(scheduler_t *s, const scheduler_config_t *config, uint32_t now_ms)
+{
+    s->config = *config;
+    limit_next_report(s, now_ms);
+}
+
+/**
+ * @brief Reavalia o ritmo a partir do status e da taxa de variação do nível
+ *
+ * urgent: status ALERTA ou PERIGO; attention: status ATENÇÃO.
+ * Retorna true quando o ritmo muda.
+ */
+bool scheduler_update(scheduler_t *s, bool urgent, bool attention, float rate_per_hour, uint32_t now_ms)
+{
+    float rate = rate_per_hour < 0 ? -rate_per_hour : rate_per_hour;
+    sched_mode_t wanted;
+
+    if (urgent || rate >= s->config.fast_rate)
+    {
+        wanted = SCHED_FAST;
+    }else if (attention || rate >= s->config.calm_rate){
+        wanted = SCHED_NORMAL;
+    }else {
+        wanted = SCHED_SLOW;
+    }
+
+    if (wanted >= s->mode)
+    {
+        s->calming = false;
+        if (wanted == s->mode)
+        {
+            return false;
+        }
+    }else {
+        // Só reduz o ritmo depois de hold_ms em condição mais calma
+        if (!s->calming)
+        {
+            s->calming = true;
+            s->calm_since_ms = now_ms;
+            return false;
+        }
+        if (now_ms - s->calm_since_ms < s->config.hold_ms)
+        {
+            return false;
+        }
+        s->calming = false;
+        wanted = s->mode - 1; // Reduz um ritmo por vez
+    }
+
+    s->mode = wanted;
+    limit_next_report(s, now_ms); // Ao acelerar, o próximo relatório não espera o intervalo antigo
+    return true;
+}
+
+/**
+ * @brief Indica se é hora de enviar um relatório (e agenda o próximo)
+ */
+bool scheduler_report_due(scheduler_t *s, uint32_t now_ms)
+{
+    if ((int32_t)(now_ms - s->next_report_ms) < 0)
+    {
+        return false;
+    }
+
+    s->next_report_ms = now_ms + s->config.report_ms[s->mode];
+    return true;
+}
+
+/**
+ * @brief Intervalo até a próxima leitura no ritmo atual
+ */
+uint32_t scheduler_sample_interval(const scheduler_t *s)
+{
+    return s->config.sample_ms[s->mode];
+}
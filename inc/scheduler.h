@@ -0,0 +1,44 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Escalonador adaptativo de leituras e relatórios
+ *
+ * Escolhe entre três ritmos de amostragem/relatório conforme o status do rio
+ * e a taxa de variação do nível. O aumento de ritmo é imediato; a redução só
+ * acontece depois de a condição mais calma se manter por hold_ms, evitando
+ * oscilações entre os ritmos.
+ */
+typedef enum {
+    SCHED_SLOW,
+    SCHED_NORMAL,
+    SCHED_FAST
+} sched_mode_t;
+
+typedef struct {
+    uint32_t sample_ms[3];   // Intervalo entre leituras, indexado por sched_mode_t
+    uint32_t report_ms[3];   // Intervalo entre relatórios, indexado por sched_mode_t
+    float fast_rate;         // |m/h| a partir da qual usa o ritmo rápido
+    float calm_rate;         // |m/h| abaixo da qual o rio é considerado calmo
+    uint32_t hold_ms;        // Permanência mínima antes de reduzir o ritmo
+} scheduler_config_t;
+
+typedef struct {
+    scheduler_config_t config;
+    sched_mode_t mode;
+    uint32_t calm_since_ms;   // Início do período em que o ritmo desejado é menor que o atual
+    bool calming;
+    uint32_t next_report_ms;
+} scheduler_t;
+
+void scheduler_default_config(scheduler_config_t *config);
+void scheduler_init(scheduler_t *s, const scheduler_config_t *config, uint32_t now_ms);
+void scheduler_set_config(scheduler_t *s, const scheduler_config_t *config, uint32_t now_ms);
+bool scheduler_update(scheduler_t *s, bool urgent, bool attention, float rate_per_hour, uint32_t now_ms);
+bool scheduler_report_due(scheduler_t *s, uint32_t now_ms);
+uint32_t scheduler_sample_interval(const scheduler_t *s);
+
+#endif /* SCHEDULER_H */
@@ -1,6 +1,15 @@
+#include <string.h>
 #include "ssd1306.h"
 #include "font.h"
 
+// Símbolos disponíveis na fonte, na ordem em que aparecem após as letras minúsculas
+static const char font_symbols[] = ".:-+%/";
+
+#ifdef SSD1306_STATIC_BUFFER
+// Framebuffer alocado estaticamente (1 byte de controle + 1 byte por coluna de cada página)
+static uint8_t static_ram_buffer[WIDTH * HEIGHT / 8 + 1];
+#endif
+
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
   ssd->width = width;
   ssd->height = height;
@@ -8,7 +17,14 @@ void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_v
   ssd->address = address;
   ssd->i2c_port = i2c;
   ssd->bufsize = ssd->pages * ssd->width + 1;
+#ifdef SSD1306_STATIC_BUFFER
+  if (ssd->bufsize > sizeof(static_ram_buffer))
+    ssd->bufsize = sizeof(static_ram_buffer);
+  memset(static_ram_buffer, 0, sizeof(static_ram_buffer));
+  ssd->ram_buffer = static_ram_buffer;
+#else
   ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+#endif
   ssd->ram_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
 }
@@ -77,20 +93,60 @@ void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
     ssd->ram_buffer[index] &= ~(1 << pixel);
 }
 
-/*
 void ssd1306_fill(ssd1306_t *ssd, bool value) {
-  uint8_t byte = value ? 0xFF : 0x00;
-  for (uint8_t i = 1; i < ssd->bufsize; ++i)
-    ssd->ram_buffer[i] = byte;
-}*/
+  // Cada byte após o de controle guarda 8 pixels; preenche todos de uma vez
+  memset(&ssd->ram_buffer[1], value ? 0xFF : 0x00, ssd->bufsize - 1);
+}
 
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
+/*
+ * Com o endereçamento vertical (SET_MEM_ADDR 0x01) as páginas de uma coluna
+ * ficam em bytes consecutivos do buffer: coluna x, página p em 1 + x * 8 + p.
+ */
+
+// Apaga as colunas x0 a x1 das páginas page0 a page1
+void ssd1306_clear_area(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1) {
+  for (uint8_t x = x0; x <= x1; ++x)
+    memset(&ssd->ram_buffer[1 + (x << 3) + page0], 0, page1 - page0 + 1);
+}
+
+// Desloca para a esquerda, em n colunas, a área entre x0 e x1 das páginas page0 a page1; as n colunas à direita ficam apagadas
+void ssd1306_scroll_left(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1, uint8_t n) {
+  uint8_t pages = page1 - page0 + 1;
+  if (n == 0)
+    return;
+  if (n > x1 - x0) {
+    ssd1306_clear_area(ssd, x0, x1, page0, page1);
+    return;
+  }
+  for (uint8_t x = x0; x + n <= x1; ++x)
+    memcpy(&ssd->ram_buffer[1 + (x << 3) + page0], &ssd->ram_buffer[1 + ((x + n) << 3) + page0], pages);
+  ssd1306_clear_area(ssd, x1 - n + 1, x1, page0, page1);
+}
+
+// Envia ao display apenas as colunas x0 a x1 das páginas page0 a page1
+void ssd1306_send_area(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1) {
+  uint8_t chunk[1 + 128];
+  uint8_t pages = page1 - page0 + 1;
+  size_t len = 1;
+
+  ssd1306_command(ssd, SET_COL_ADDR);
+  ssd1306_command(ssd, x0);
+  ssd1306_command(ssd, x1);
+  ssd1306_command(ssd, SET_PAGE_ADDR);
+  ssd1306_command(ssd, page0);
+  ssd1306_command(ssd, page1);
+
+  // O display mantém a posição de escrita entre transferências; os dados seguem em blocos
+  chunk[0] = 0x40;
+  for (uint8_t x = x0; x <= x1; ++x) {
+    if (len + pages > sizeof(chunk)) {
+      i2c_write_blocking(ssd->i2c_port, ssd->address, chunk, len, false);
+      len = 1;
     }
+    memcpy(&chunk[len], &ssd->ram_buffer[1 + (x << 3) + page0], pages);
+    len += pages;
+  }
+  i2c_write_blocking(ssd->i2c_port, ssd->address, chunk, len, false);
 }
 
 
@@ -166,6 +222,8 @@ void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
     index = (c - '0' + 1) * 8; // Adiciona o deslocamento necessário
   }else if (c >= 'a' && c <= 'z'){
     index = (c - 'a' + 37) * 8; // Para letras minúsculas 
+  }else if (c && strchr(font_symbols, c)){
+    index = (strchr(font_symbols, c) - font_symbols + 63) * 8; // Símbolos, após as letras minúsculas
   }
   
   for (uint8_t i = 0; i < 8; ++i)
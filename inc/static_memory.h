@@ -0,0 +1,17 @@
+#ifndef STATIC_MEMORY_H
+#define STATIC_MEMORY_H
+
+/**
+ * @brief Proibição do heap no código do projeto (modo STATIC_MEMORY)
+ *
+ * Incluído à força (-include) em todos os fontes do projeto quando a opção
+ * STATIC_MEMORY está ativa: qualquer uso de malloc/calloc/realloc/free depois
+ * deste ponto é erro de compilação. stdlib.h é incluído antes para que suas
+ * próprias declarações não sejam rejeitadas. Os fontes do SDK não recebem este
+ * arquivo; o uso de heap por eles é verificado por tools/stack_report.py.
+ */
+#include <stdlib.h>
+
+#pragma GCC poison malloc calloc realloc free
+
+#endif /* STATIC_MEMORY_H */
@@ -0,0 +1,88 @@
+#include "trend.h"
+
+/**
+ * @brief Inicializa o estimador com os fatores de suavização informados
+ */
+void trend_init(trend_t *t, float alpha, float beta)
+{
+    t->level = 0.0f;
+    t->slope = 0.0f;
+    t->alpha = alpha;
+    t->beta = beta;
+    t->last_ms = 0;
+    t->samples = 0;
+}
+
+/**
+ * @brief Incorpora uma nova leitura do nível do rio
+ *
+ * O nível previsto para o instante atual é corrigido pela leitura, e a
+ * diferença entre o nível novo e o anterior (normalizada pelo intervalo)
+ * atualiza a taxa de variação.
+ */
+void trend_update(trend_t *t, float sample, uint32_t now_ms)
+{
+    if (t->samples == 0)
+    {
+        t->level = sample;
+        t->slope = 0.0f;
+        t->last_ms = now_ms;
+        t->samples = 1;
+        return;
+    }
+
+    uint32_t elapsed_ms = now_ms - t->last_ms;
+    if (elapsed_ms == 0)
+    {
+        return;
+    }
+
+    float dt = elapsed_ms / 1000.0f;
+    float predicted = t->level + t->slope * dt;
+    float level = t->alpha * sample + (1.0f - t->alpha) * predicted;
+
+    t->slope = t->beta * ((level - t->level) / dt) + (1.0f - t->beta) * t->slope;
+    t->level = level;
+    t->last_ms = now_ms;
+    t->samples++;
+}
+
+/**
+ * @brief Retorna a taxa de variação do nível em metros por hora
+ */
+float trend_rate_per_hour(const trend_t *t)
+{
+    return t->slope * 3600.0f;
+}
+
+/**
+ * @brief Projeta o tempo (s) até o nível atingir o limite informado
+ *
+ * Retorna 0 se o limite já foi atingido e TREND_NO_ETA se o rio não está
+ * subindo ou se ainda não há amostras suficientes para uma estimativa.
+ */
+int32_t trend_time_to_level(const trend_t *t, float threshold)
+{
+    if (t->samples < TREND_MIN_SAMPLES)
+    {
+        return TREND_NO_ETA;
+    }
+
+    if (t->level >= threshold)
+    {
+        return 0;
+    }
+
+    if (t->slope < TREND_MIN_SLOPE)
+    {
+        return TREND_NO_ETA;
+    }
+
+    float eta = (threshold - t->level) / t->slope;
+    if (eta > (float)INT32_MAX)
+    {
+        return TREND_NO_ETA;
+    }
+
+    return (int32_t)eta;
+}
@@ -0,0 +1,49 @@
+#ifndef TREND_H
+#define TREND_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Estimador incremental de tendência do nível do rio
+ *
+ * Utiliza suavização exponencial dupla (Holt) com intervalo de amostragem
+ * variável. Cada atualização é O(1) e o estado ocupa memória fixa, sem
+ * nenhum histórico de amostras.
+ */
+typedef struct {
+    float level;        // Nível suavizado (m)
+    float slope;        // Taxa de variação suavizada (m/s)
+    float alpha;        // Peso da amostra nova no nível
+    float beta;         // Peso da variação nova na tendência
+    uint32_t last_ms;   // Instante da última amostra
+    uint32_t samples;   // Quantidade de amostras processadas
+} trend_t;
+
+/**
+ * @brief Valores padrão dos fatores de suavização
+ */
+#define TREND_ALPHA 0.3f
+#define TREND_BETA 0.1f
+
+/**
+ * @brief Quantidade mínima de amostras antes de projetar o tempo até os limites
+ */
+#define TREND_MIN_SAMPLES 10
+
+/**
+ * @brief Taxa mínima (m/s) para considerar que o rio está subindo (~1 cm/h)
+ */
+#define TREND_MIN_SLOPE (0.01f / 3600.0f)
+
+/**
+ * @brief Valor retornado quando o limite não será atingido com a tendência atual
+ */
+#define TREND_NO_ETA (-1)
+
+void trend_init(trend_t *t, float alpha, float beta);
+void trend_update(trend_t *t, float sample, uint32_t now_ms);
+float trend_rate_per_hour(const trend_t *t);
+int32_t trend_time_to_level(const trend_t *t, float threshold);
+
+#endif /* TREND_H */
@@ -9,6 +9,8 @@
 #define LWIP_UDP 1
 #define MEM_ALIGNMENT 4
 #define MEM_SIZE 4096
+#define MEM_LIBC_MALLOC 0               // Heap do lwIP em área estática (MEM_SIZE), sem malloc da libc
+#define MEMP_MEM_MALLOC 0               // Pools do lwIP alocados estaticamente
 #define MEMP_NUM_PBUF 16
 #define PBUF_POOL_SIZE 16               // Ajuste conforme necessário
 #define MEMP_NUM_UDP_PCB 4
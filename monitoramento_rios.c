@@ -1,12 +1,24 @@
 #include <stdio.h>
+#include <string.h>
+#include <strings.h>
 #include "pico/stdlib.h"
 #include "pico/time.h"
+#include "pico/stdio_usb.h"
 #include "hardware/clocks.h"
 #include "hardware/adc.h"
 #include "hardware/i2c.h"
 #include "hardware/uart.h"
 #include "inc/ssd1306.h"
 #include "inc/font.h"
+#include "inc/trend.h"
+#include "inc/report_uart.h"
+#include "inc/gateway.h"
+#include "inc/scheduler.h"
+#include "inc/config.h"
+#include "inc/history.h"
+#include "inc/chart.h"
+#include "inc/display.h"
+#include "site_config.h"
 
 #include "pico/stdlib.h"         // Biblioteca da Raspberry Pi Pico para funções padrão (GPIO, temporização, etc.)
 #include "hardware/adc.h"        // Biblioteca da Raspberry Pi Pico para manipulação do conversor ADC
@@ -14,17 +26,18 @@
 
 #include "lwip/pbuf.h"           // Lightweight IP stack - manipulação de buffers de pacotes de rede
 #include "lwip/tcp.h"            // Lightweight IP stack - fornece funções e estruturas para trabalhar com o protocolo TCP
+#include "lwip/udp.h"            // Lightweight IP stack - envio/recepção dos relatórios do gateway
 #include "lwip/netif.h"          // Lightweight IP stack - fornece funções e estruturas para trabalhar com interfaces de rede (netif)
 
 /** ====================================== DEFINIÇÕES/FUNÇÕES DO WEBSERVER ====================================== */
-#define WIFI_SSID "SEU SSID"
-#define WIFI_PASSWORD "SUA SENHA"
-
 #define LED 12
 #define SEND_REPORT 0
 #define SEND_STATUS 1
 #define BUZZER_ALERT 2
 #define LED_ALERT 3
+#define SHOW_GATEWAY 4
+#define CONFIG_GET 5
+#define CONFIG_POST 6
 
 int type_request = 0;
 
@@ -34,6 +47,10 @@ typedef struct  {
     float curr_river_l;
     float curr_rain_i;
     float last_river_l;
+    float trend;
+    int32_t eta_attention;
+    int32_t eta_alert;
+    int32_t eta_danger;
     char status[200];
 } WebserverValues;
 /** ============================================================================================================== */
@@ -47,7 +64,7 @@ typedef struct  {
 #define HC_SR04 27
 
 /** 
- * @brief Pino ligado ao Botão A - Simula o recebimento de solicitações do usuário
+ * @brief Pino ligado ao Botão A - Troca a tela do display; pressionado por mais tempo, simula o recebimento de solicitações do usuário
  **/
 #define BUTTON_A 5
 
@@ -64,17 +81,70 @@ typedef struct  {
  */
 #define UART_ID uart0
 #define BAUD_RATE 115200
+#define UART_TX_PIN 0
+#define UART_RX_PIN 1
 
 /**
- * @brief Intervalo de tempo entre os envios de relatórios
+ * Os intervalos entre leituras e entre relatórios são definidos pelo escalonador
+ * adaptativo (inc/scheduler.h), com valores por local de instalação em site_config.h
+ */
+
+/**
+ * Calibração dos sensores e limites de classificação do status são lidos da
+ * configuração da estação (inc/config.h), alterável pelo endpoint /config
  */
-#define REPORT_TIME 10000 
 
 /**
  * @brief Tempo (ms) para tratamento de bouncing do botão 
  */
 #define DEBOUNCE_TIME_MS 500 
 
+/**
+ * @brief Tempo (ms) a partir do qual o botão pressionado gera um relatório em vez de trocar a tela
+ */
+#define LONG_PRESS_MS 1000
+
+/**
+ * @brief Tempo (ms) após o pressionamento em que a soltura do botão é tratada como bouncing
+ */
+#define RELEASE_BOUNCE_MS 50
+
+/**
+ * @brief Tempo (ms) com o botão A pressionado ao ligar para descartar a configuração gravada
+ */
+#define CONFIG_RESET_HOLD_MS 3000
+
+/**
+ * @brief Tamanho máximo do request HTTP lido
+ */
+#define HTTP_REQUEST_MAX 1024
+
+/**
+ * @brief Tempo (ms) máximo de espera pelo restante de um request recebido em vários segmentos TCP
+ */
+#define HTTP_REQUEST_TIMEOUT_MS 5000
+
+/**
+ * @brief Respostas enviadas em partes: tamanho de cada parte e conexões simultâneas (MEMP_NUM_TCP_PCB)
+ */
+#define HTTP_CHUNK_MAX 512
+#define HTTP_STREAMS 4
+
+/**
+ * @brief Identificação desta estação e endereço do gateway que recebe seus relatórios
+ *
+ * Definidos pelo CMake (STATION_ID, GATEWAY_ADDR). Com GATEWAY_ADDR vazio os
+ * relatórios não são enviados. No modo gateway (GATEWAY_MODE) a placa também
+ * recebe os relatórios das outras estações e serve a visão consolidada em /gateway.
+ */
+#ifndef STATION_ID
+#define STATION_ID 1
+#endif
+
+#ifndef GATEWAY_ADDR
+#define GATEWAY_ADDR ""
+#endif
+
 /** ====================================== PROTÓTITPOS DE FUNÇÕES WEBSERVER ====================================== */
 // Função de callback ao aceitar conexões TCP
 static err_t tcp_server_accept(void *arg, struct tcp_pcb *newpcb, err_t err);
@@ -87,6 +157,12 @@ void user_request(char **request);
 
 int wifi_init();
 
+// Configuração do UDP para os relatórios do gateway
+void gateway_udp_init();
+
+// Envio (ou registro local, no modo gateway) do último relatório desta estação
+void send_gateway_report();
+
 /** ============================================================================================================== */
 //Variáveis Globais
 ssd1306_t ssd;
@@ -94,14 +170,25 @@ uint32_t adc_x_value;
 uint32_t adc_y_value;
 uint32_t current_time;
 uint32_t last_debounce_time = 0;
-float river_level = 5.0;
-float intense_rain = 100.0;
+volatile bool button_down = false; //Botão A pressionado (aguardando a soltura)
+volatile bool display_request = false; //Troca de tela solicitada pelo botão A
+volatile bool report_request = false; //Relatório solicitado pelo botão A
 float current_river_level;
 float last_river_level;
 float current_rain_intensity;
 int status;
 enum level_status {ATTENTION, ALERT, DANGER, SAFE};
 WebserverValues w; //Guarda valores de variaveis exibidas em requests
+trend_t level_trend; //Estimativa da tendência do nível do rio
+history_t level_history; //Nível e chuva das últimas horas (gráfico da página e do display)
+display_t display; //Telas do display
+scheduler_t scheduler; //Ritmo atual de leituras e relatórios
+gateway_report_t station_report; //Último relatório desta estação no formato do gateway
+volatile bool station_report_pending = false; //Indica relatório aguardando envio ao gateway
+struct udp_pcb *gateway_pcb; //PCB UDP para envio (estação) ou recepção (gateway) de relatórios
+#if GATEWAY_MODE
+gateway_t gateway; //Relatórios recebidos de todas as estações
+#endif
 /**
  * @brief Procedimento para configurar e inicializar o Joystick
  */
@@ -144,40 +231,144 @@ void init_button()
     gpio_pull_up(BUTTON_A);
 }
 
+/**
+ * @brief Verifica se o botão A está pressionado desde a inicialização por pelo menos hold_ms
+ */
+bool button_held_at_boot(uint32_t hold_ms)
+{
+    sleep_ms(10); // Estabilização do pull-up
+    absolute_time_t until = make_timeout_time_ms(hold_ms);
+    while (!gpio_get(BUTTON_A))
+    {
+        if (time_reached(until))
+        {
+            return true;
+        }
+        sleep_ms(10);
+    }
+    return false;
+}
+
+/**
+ * @brief Formata o tempo estimado até um limite ("--" quando não há previsão)
+ */
+void format_eta(char *buf, size_t size, int32_t eta)
+{
+    if (eta == TREND_NO_ETA)
+    {
+        snprintf(buf, size, "--");
+    }else if (eta == 0){
+        snprintf(buf, size, "atingido");
+    }else {
+        snprintf(buf, size, "%ld min", (long)((eta + 59) / 60));
+    }
+}
+
+#if REPORT_FORMAT == REPORT_FORMAT_CSV
+/**
+ * @brief Monta o relatório em uma única linha CSV terminada por checksum
+ *
+ * Formato: R,id,ms,nivel,chuva,status,dif,tendencia,eta_atencao,eta_alerta,eta_perigo,descartes*CK
+ * CK é o XOR (em hexadecimal) de todos os caracteres entre 'R' e '*', inclusive 'R'.
+ */
+size_t format_report(char *frame, size_t size, uint id, const char *status_name)
+{
+    size_t len = 0;
+    report_uart_stats_t stats;
+    report_uart_get_stats(&stats);
+
+    report_uart_appendf(frame, size, &len, "R,%u,%lu,%.2f,%.2f,%s,%.2f,%.3f,%ld,%ld,%ld,%lu",
+                        id, (unsigned long)to_ms_since_boot(get_absolute_time()),
+                        w.curr_river_l, w.curr_rain_i, status_name, w.diff, w.trend,
+                        (long)w.eta_attention, (long)w.eta_alert, (long)w.eta_danger,
+                        (unsigned long)stats.frames_dropped);
+
+    uint8_t checksum = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        checksum ^= (uint8_t)frame[i];
+    }
+    report_uart_appendf(frame, size, &len, "*%02X\r\n", checksum);
+
+    return len;
+}
+#else
+/**
+ * @brief Acrescenta ao relatório a previsão de tempo até o limite de um status
+ */
+void append_eta(char *frame, size_t size, size_t *len, const char *name, int32_t eta)
+{
+    char text[20];
+    format_eta(text, sizeof(text), eta);
+    report_uart_appendf(frame, size, len, "Previsao %s: %s\n", name, text);
+}
+
+/**
+ * @brief Monta o relatório em texto legível, uma informação por linha
+ */
+size_t format_report(char *frame, size_t size, uint id, const char *status_name)
+{
+    size_t len = 0;
+
+    report_uart_appendf(frame, size, &len, "\nID %u\n", id);
+    report_uart_appendf(frame, size, &len, "Nível: %.2f\n", w.curr_river_l);
+    if (w.curr_rain_i > 0)
+    {
+        report_uart_appendf(frame, size, &len, "Chuva: %.2f%%\n", w.curr_rain_i);
+    }else {
+        report_uart_appendf(frame, size, &len, "Sem chuva.\n");
+    }
+    report_uart_appendf(frame, size, &len, "Status: %s\n", status_name);
+    if (w.last_river_l)
+    {
+        report_uart_appendf(frame, size, &len, "Dif:%.2f%%\n", w.curr_river_l - w.last_river_l);
+    }
+    report_uart_appendf(frame, size, &len, "Tendencia: %+.2f m/h\n", w.trend);
+    append_eta(frame, size, &len, "ATENCAO", w.eta_attention);
+    append_eta(frame, size, &len, "ALERTA", w.eta_alert);
+    append_eta(frame, size, &len, "PERIGO", w.eta_danger);
+
+    return len;
+}
+#endif
+
 /**
  * @brief Reúne informações de relatório e faz o envio para o usuário
+ *
+ * O relatório é montado por completo em memória e enfileirado para envio via
+ * DMA pela UART, sem bloquear. Chamada apenas no laço principal (o botão A
+ * apenas solicita o relatório), pois as informações do relatório são
+ * compartilhadas sem proteção com send_gateway_report() e a página web.
  */
 void send_report()
 {
+    const station_config_t *cfg = config_get();
     static volatile uint report_id = 1;
     float diff_p = 0.0;
-    char *message;
+    const char *status_name;
     static char html[200];
-
-    printf("\nID %d\n", report_id++);
-    printf("Nível: %.2f\n", current_river_level);
-    (current_rain_intensity > 0) ? printf("Chuva: %.2f%%\n", current_rain_intensity) :  printf("Sem chuva.\n");
+    char frame[REPORT_FRAME_MAX];
 
     switch (status)
     {
     case ATTENTION:
-        printf("Status: ATENÇÃO\n");
+        status_name = "ATENCAO";
         snprintf(html, sizeof(html), "Status: ATENÇÃO");
         break;
     case ALERT:
-        printf("Status: ALERTA\n");
+        status_name = "ALERTA";
         snprintf(html, sizeof(html), "Status: ALERTA");
         break;
     case DANGER:
-        printf("Status: PERIGO\n");
+        status_name = "PERIGO";
         snprintf(html, sizeof(html), "Status: PERIGO");
         break;
     case SAFE:
-        printf("Status: SEGURO\n");
+        status_name = "SEGURO";
         snprintf(html, sizeof(html), "Status: SEGURO");
         break;
     default:
-        printf("Status: Erro\n");
+        status_name = "ERRO";
         break;
     }
 
@@ -185,58 +376,158 @@ void send_report()
     {
         float diff = current_river_level - last_river_level;
         diff_p = (diff / last_river_level) * 100.0;
-        printf("Dif:%.2f%%", diff);
     }
 
-    w.ID = report_id;
+    //A página web (callbacks do lwIP) lê o relatório durante o envio
+    cyw43_arch_lwip_begin();
+    uint id = report_id++;
+    w.ID = id;
     w.diff = diff_p;
     w.curr_rain_i = current_rain_intensity;
     w.curr_river_l = current_river_level;
     w.last_river_l = last_river_level;
+    w.trend = trend_rate_per_hour(&level_trend);
+    w.eta_attention = trend_time_to_level(&level_trend, cfg->river_level);
+    w.eta_alert = trend_time_to_level(&level_trend, cfg->alert_level);
+    w.eta_danger = trend_time_to_level(&level_trend, cfg->danger_level);
     strcpy(w.status, html);
+    cyw43_arch_lwip_end();
+
+    size_t len = format_report(frame, sizeof(frame), id, status_name);
+    report_uart_write(frame, len); // Em caso de buffer cheio, o relatório é descartado e contabilizado
+
+    //Cópia na USB, quando há um terminal conectado
+    if (stdio_usb_connected())
+    {
+        printf("%.*s", (int)len, frame);
+    }
+
+    //O envio ao gateway (lwIP) é feito em send_gateway_report()
+    int status_index = gateway_status_index(status_name);
+    station_report.station = STATION_ID;
+    station_report.report_id = id;
+    station_report.level = w.curr_river_l;
+    station_report.rain = w.curr_rain_i;
+    station_report.trend = w.trend;
+    station_report.status = status_index < 0 ? 0 : status_index;
+    station_report_pending = true;
 
     last_river_level = current_river_level;
 }
 
 /**
- * @brief Gera um relatório e envia as informações para o usuário (quando solicitada)
+ * @brief Troca a tela do display (toque curto) ou gera um relatório e envia as informações para o usuário (toque longo)
  * Função de Callback para tratamento de interrupção acionada pelo Botão A
+ *
+ * A tela é trocada e o relatório é gerado no laço principal: o display usa o I2C de
+ * forma bloqueante e o relatório não pode ser interrompido no meio de sua montagem.
  */
 static void gpio_irq_handler(uint gpio, uint32_t events)
 {
     current_time = to_ms_since_boot(get_absolute_time());
 
     //Tratamento de bouncing
-    if ((current_time - last_debounce_time) > DEBOUNCE_TIME_MS)
+    if ((events & GPIO_IRQ_EDGE_FALL) && (current_time - last_debounce_time) > DEBOUNCE_TIME_MS)
     {
         last_debounce_time = current_time;
-        send_report();
+        button_down = true;
+    }else if ((events & GPIO_IRQ_EDGE_RISE) && button_down && (current_time - last_debounce_time) > RELEASE_BOUNCE_MS){
+        button_down = false;
+        if ((current_time - last_debounce_time) >= LONG_PRESS_MS)
+        {
+            report_request = true;
+        }else {
+            display_request = true;
+        }
     }
 }
 
 /**
- * @brief Função callback do alarme que faz o envio periódico do relatório
+ * @brief Ajusta o modo de economia de energia do Wi-Fi ao ritmo atual
+ *
+ * No ritmo lento o rádio fica a maior parte do tempo desligado entre os
+ * beacons do ponto de acesso (maior latência nas requisições web).
  */
-bool repeating_timer_callback(struct repeating_timer *t)
+void apply_power_mode(sched_mode_t mode)
 {
-    send_report();
-    return true;
+    cyw43_arch_lwip_begin();
+    cyw43_wifi_pm(&cyw43_state, mode == SCHED_SLOW ? CYW43_AGGRESSIVE_PM : CYW43_PERFORMANCE_PM);
+    cyw43_arch_lwip_end();
+}
+
+/**
+ * @brief Escala do gráfico (página web e display) a partir da configuração atual
+ */
+chart_scale_t current_chart_scale()
+{
+    const station_config_t *cfg = config_get();
+    float level_max = 2.0f * cfg->river_level; // Maior nível medido (verify_river_level)
+
+    chart_scale_t scale = {
+        .level_max = level_max > 1.1f * cfg->danger_level ? level_max : 1.1f * cfg->danger_level,
+        .rain_max = cfg->intense_rain,
+        .alert_level = cfg->alert_level,
+        .danger_level = cfg->danger_level,
+    };
+    return scale;
 }
 
 /**
  * @brief Envia uma notificação para o usuário (Exibição no display)
+ *
+ * Reúne as informações de todas as telas; apenas a tela atual é redesenhada,
+ * e somente nas partes que mudaram.
  */
 void send_notification(char *notification)
 {
-    char level[20];
-    sprintf(level, "%.2f", current_river_level);
+    const station_config_t *cfg = config_get();
+    display_info_t info = {0};
+
+    //Exibe o próximo limite que será atingido caso o rio continue subindo
+    info.next_eta = TREND_NO_ETA;
+    if (current_river_level < cfg->river_level)
+    {
+        info.next_eta = trend_time_to_level(&level_trend, cfg->river_level);
+        info.next_name = "ATENCAO";
+    }else if (current_river_level < cfg->alert_level){
+        info.next_eta = trend_time_to_level(&level_trend, cfg->alert_level);
+        info.next_name = "ALERTA";
+    }else if (current_river_level < cfg->danger_level){
+        info.next_eta = trend_time_to_level(&level_trend, cfg->danger_level);
+        info.next_name = "PERIGO";
+    }
+
+    info.status = notification;
+    info.level = current_river_level;
+    info.rain = current_rain_intensity;
+    info.trend = trend_rate_per_hour(&level_trend);
+    info.scale = current_chart_scale();
 
-    ssd1306_fill(&ssd, false); // Limpa o display
-    ssd1306_rect(&ssd, 3, 3, 122, 58, true, false); // Desenha um retângulo
-    ssd1306_draw_string(&ssd, notification, 40, 20); // Desenha uma string
-    ssd1306_draw_string(&ssd, "NIVEL: ", 10, 40);
-    ssd1306_draw_string(&ssd, level, 60, 40);
-    ssd1306_send_data(&ssd); // Atualiza o display
+    //Diagnóstico: consultar o rádio (RSSI) só vale a pena com a tela de rede visível
+    if (display.screen == DISPLAY_NETWORK)
+    {
+        report_uart_stats_t stats;
+        report_uart_get_stats(&stats);
+
+        cyw43_arch_lwip_begin();
+        if (netif_default && netif_is_link_up(netif_default))
+        {
+            snprintf(info.ip, sizeof(info.ip), "%s", ipaddr_ntoa(&netif_default->ip_addr));
+            cyw43_wifi_get_rssi(&cyw43_state, &info.rssi);
+        }
+        cyw43_arch_lwip_end();
+
+        info.station = STATION_ID;
+#if GATEWAY_MODE
+        info.stations = gateway.count;
+#endif
+        info.sched_mode = scheduler.mode;
+        info.frames_dropped = stats.frames_dropped;
+        info.config_version = cfg->version;
+        info.uptime_s = to_ms_since_boot(get_absolute_time()) / 1000;
+    }
+
+    display_update(&display, &info, &level_history);
 }
 
 /**
@@ -244,6 +535,9 @@ void send_notification(char *notification)
  */
 void verify_river_level()
 {
+    const station_config_t *cfg = config_get();
+    float river_level = cfg->river_level;
+
     adc_select_input(0);
     adc_x_value = adc_read();
 
@@ -251,10 +545,10 @@ void verify_river_level()
     adc_y_value = adc_read();
 
     //Calcula o nível do rio com base nos valores fornecidos pelo adc do eixo Y
-    if (adc_y_value > 2100){
+    if (adc_y_value > cfg->adc_high){
         //Indica que o nível do rio subiu; calcula o valor atual (pode aumentar até 10.0 metros)
         current_river_level = river_level + (river_level * (adc_y_value - 2048) / 2047);
-    }else if (adc_y_value < 1800){
+    }else if (adc_y_value < cfg->adc_low){
         //Indica que o nível do rio desceu; calcula o valor atual (pode diminuir até 0 metros)
         current_river_level = river_level - (river_level * (2048 - adc_y_value) / 2047);
     }else {
@@ -262,7 +556,7 @@ void verify_river_level()
     }
 
     //Calcula a intensidade da chuva com base nos valores do eixo X
-    current_rain_intensity = (intense_rain * adc_x_value) / 4095.0;
+    current_rain_intensity = (cfg->intense_rain * adc_x_value) / 4095.0;
 }
 
 /**
@@ -276,17 +570,18 @@ void verify_river_level()
  */
 void set_river_status()
 {
-  
+    const station_config_t *cfg = config_get();
+    float river_level = cfg->river_level;
     char *message;
 
-    if (current_river_level >= 9.0 || (current_river_level >= 7.0 && current_rain_intensity > 50.0))
+    if (current_river_level >= cfg->danger_level || (current_river_level >= cfg->alert_level && current_rain_intensity > cfg->rain_alert))
     {
         status = DANGER;
         message = "PERIGO";
-    }else if ((current_river_level >= 7.0 && current_rain_intensity > 50.0) || (current_river_level > river_level && current_rain_intensity > 50.0)){
+    }else if ((current_river_level >= cfg->alert_level && current_rain_intensity > cfg->rain_alert) || (current_river_level > river_level && current_rain_intensity > cfg->rain_alert)){
         status = ALERT;
         message = "ALERTA";
-    }else if ((current_river_level > river_level && current_rain_intensity <= 50.0) || (current_river_level <= river_level && current_rain_intensity > 70.0)){
+    }else if ((current_river_level > river_level && current_rain_intensity <= cfg->rain_alert) || (current_river_level <= river_level && current_rain_intensity > cfg->rain_attention)){
         status = ATTENTION;
         message = "ATENCAO";
     }else {
@@ -299,46 +594,121 @@ void set_river_status()
 
 int main()
 {
+    //Carrega a configuração da estação gravada na flash (ou os valores padrão de site_config.h)
+    config_init();
+
+    //Botão A mantido pressionado ao ligar: descarta a configuração gravada (credenciais ou token perdidos)
+    init_button();
+    bool config_restored = button_held_at_boot(CONFIG_RESET_HOLD_MS);
+    if (config_restored)
+    {
+        config_reset();
+    }
+
     //Faz as configurações e inicializações necessárias para conexão com o Wi-Fi
     wifi_init();
 
     //Realiza as inicializações e configurações dos dispositivos
     stdio_init_all();
+    if (config_restored)
+    {
+        printf("Configuração restaurada para os valores de site_config.h\n");
+    }
     init_joystick();
-    init_button();
     init_i2c_display();
-    uart_init(UART_ID, BAUD_RATE);
+    display_init(&display, &ssd);
+    report_uart_init(UART_ID, BAUD_RATE, UART_TX_PIN, UART_RX_PIN);
 
 
     /**
      * @brief Função de interrupção para tratamento de ação ao acionar o Botão A 
      * @see gpio_irq_handler()
      */
-    gpio_set_irq_enabled_with_callback(BUTTON_A, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);
+    gpio_set_irq_enabled_with_callback(BUTTON_A, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true, &gpio_irq_handler);
+
     /**
-     * @brief Aciona uma função de callback de maneira periódica para enviar relatórios
-     * @see repeating_timer_callback()
+     * @brief Escalonador que define os intervalos de leitura e de envio de relatórios
+     * @see scheduler_update()
      */
-    repeating_timer_t timer;
-    add_repeating_timer_ms(REPORT_TIME, repeating_timer_callback, NULL, &timer);
+    uint32_t config_version = config_get()->version;
+    scheduler_init(&scheduler, &config_get()->sched, to_ms_since_boot(get_absolute_time()));
+    apply_power_mode(scheduler.mode);
 
     /**
      * Faz a primeira leitura do nível do rio quando o sistema é iniciado
      * para garantir que as informações do relatório estejam corretas */
+    trend_init(&level_trend, TREND_ALPHA, TREND_BETA);
+    history_init(&level_history, HISTORY_BUCKET_MS);
     verify_river_level();
     last_river_level = current_river_level;
 
+    absolute_time_t next_sample = get_absolute_time();
+
     while (true) {
+        uint32_t now = to_ms_since_boot(get_absolute_time());
+
+        //Aplica ao escalonador os intervalos de uma configuração recebida em /config
+        config_ack(); // Nenhuma configuração da iteração anterior continua em uso
+        const station_config_t *cfg = config_get();
+        if (cfg->version != config_version)
+        {
+            config_version = cfg->version;
+            scheduler_set_config(&scheduler, &cfg->sched, now);
+        }
+
         verify_river_level();
+        trend_update(&level_trend, current_river_level, now);
+
+        //O histórico é lido pelo servidor web (callbacks do lwIP) durante o envio do gráfico
+        cyw43_arch_lwip_begin();
+        history_add(&level_history, current_river_level, current_rain_intensity, now);
+        cyw43_arch_lwip_end();
         set_river_status();
 
+        //Acelera com o rio em ALERTA/PERIGO ou variando rápido; desacelera com o rio calmo
+        if (scheduler_update(&scheduler, status == ALERT || status == DANGER, status == ATTENTION,
+                             trend_rate_per_hour(&level_trend), now))
+        {
+            apply_power_mode(scheduler.mode);
+        }
+        if (scheduler_report_due(&scheduler, now) || report_request)
+        {
+            report_request = false;
+            send_report();
+        }
+        send_gateway_report();
+        config_save_pending();
+
         cyw43_arch_poll(); // Mantém o Wi-Fi ativo
+
         /**
-         * O intervalo é definido com tempo relativamente baixo, em uma implementação
-         * real do sistema, os intervalos seriam maiores, para se encaixar melhor a necessidade
-         * de checagem e verificação do nível do rio
-         */  
-        sleep_ms(1000);
+         * Dorme (WFE) até a próxima leitura. As interrupções (botão, Wi-Fi, DMA da UART)
+         * continuam sendo atendidas; a troca de tela pelo botão A é feita assim que
+         * solicitada, sem esperar a próxima leitura. O modo dormant não é usado porque
+         * desligaria os clocks do Wi-Fi e o servidor web deixaria de responder.
+         */
+        uint32_t interval = scheduler_sample_interval(&scheduler);
+        next_sample = delayed_by_ms(next_sample, interval);
+        if (absolute_time_diff_us(get_absolute_time(), next_sample) <= 0)
+        {
+            next_sample = make_timeout_time_ms(interval);
+        }
+        while (!best_effort_wfe_or_timeout(next_sample))
+        {
+            config_ack(); // Libera uma nova alteração recebida durante a espera
+            if (report_request)
+            {
+                report_request = false;
+                send_report(); // Relatório solicitado pelo botão A
+                send_gateway_report();
+            }
+            if (display_request)
+            {
+                display_request = false;
+                display_next_screen(&display);
+                set_river_status(); // Desenha a nova tela com os valores da última leitura
+            }
+        }
     }
 
     cyw43_arch_deinit(); //Desliga a arquitetura CYW43
@@ -362,11 +732,18 @@ int wifi_init()
 
     // Conectar à rede WiFI - fazer um loop até que esteja conectado
     printf("Conectando ao Wi-Fi...\n");
-    while (cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK, 20000))
+    const station_config_t *cfg = config_get();
+    if (cyw43_arch_wifi_connect_timeout_ms(cfg->wifi_ssid, cfg->wifi_password, CYW43_AUTH_WPA2_AES_PSK, 20000))
     {
-        printf("Falha ao conectar ao Wi-Fi\n");
-        sleep_ms(100);
-        return -1;
+        //Credenciais alteradas por /config que não funcionam: tenta as de site_config.h
+        bool compiled = strcmp(cfg->wifi_ssid, WIFI_SSID) == 0 && strcmp(cfg->wifi_password, WIFI_PASSWORD) == 0;
+        if (compiled || cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK, 20000))
+        {
+            printf("Falha ao conectar ao Wi-Fi\n");
+            sleep_ms(100);
+            return -1;
+        }
+        printf("Credenciais da configuração falharam; conectado com as de site_config.h\n");
     }
     printf("Conectado ao Wi-Fi\n");
 
@@ -398,12 +775,483 @@ int wifi_init()
     tcp_accept(server, tcp_server_accept);
     printf("Servidor ouvindo na porta 80\n");
 
+    gateway_udp_init();
+
     return 0;
 }
 
+#if GATEWAY_MODE
+// Função de callback para os relatórios recebidos das estações
+static void gateway_udp_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, uint16_t port)
+{
+    char line[GATEWAY_REPORT_MAX];
+    gateway_report_t report;
+
+    uint16_t len = pbuf_copy_partial(p, line, sizeof(line), 0);
+    pbuf_free(p);
+
+    if (gateway_parse_report(line, len, &report))
+    {
+        gateway_ingest(&gateway, &report, to_ms_since_boot(get_absolute_time()));
+    }else {
+        gateway.rejected++;
+    }
+}
+#endif
+
+// Configura o PCB UDP usado para os relatórios do gateway
+void gateway_udp_init()
+{
+#if GATEWAY_MODE
+    gateway_init(&gateway, GATEWAY_SLOT_MS);
+    gateway_pcb = udp_new();
+    if (!gateway_pcb || udp_bind(gateway_pcb, IP_ADDR_ANY, GATEWAY_PORT) != ERR_OK)
+    {
+        printf("Falha ao associar gateway à porta UDP %d\n", GATEWAY_PORT);
+        return;
+    }
+    udp_recv(gateway_pcb, gateway_udp_recv, NULL);
+    printf("Gateway ouvindo na porta UDP %d\n", GATEWAY_PORT);
+#else
+    if (GATEWAY_ADDR[0])
+    {
+        gateway_pcb = udp_new();
+    }
+#endif
+}
+
+void send_gateway_report()
+{
+    gateway_report_t report;
+
+    if (!station_report_pending)
+    {
+        return;
+    }
+
+    //O relatório é preenchido em send_report(), também no laço principal
+    report = station_report;
+    station_report_pending = false;
+
+    cyw43_arch_lwip_begin();
+#if GATEWAY_MODE
+    gateway_ingest(&gateway, &report, to_ms_since_boot(get_absolute_time()));
+#else
+    char line[GATEWAY_REPORT_MAX];
+    ip_addr_t addr;
+    size_t len = gateway_format_report(line, sizeof(line), &report);
+    if (gateway_pcb && len && ipaddr_aton(GATEWAY_ADDR, &addr))
+    {
+        struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, len, PBUF_RAM);
+        if (p)
+        {
+            memcpy(p->payload, line, len);
+            udp_sendto(gateway_pcb, p, &addr, GATEWAY_PORT);
+            pbuf_free(p);
+        }
+    }
+#endif
+    cyw43_arch_lwip_end();
+}
+
+/**
+ * @brief Estado de uma resposta HTTP enviada em partes (página principal e do gateway)
+ *
+ * A página é gerada um trecho por vez conforme o TCP libera espaço no buffer
+ * de envio (callback tcp_sent), sem precisar de um buffer do tamanho da página.
+ */
+typedef struct http_stream http_stream_t;
+
+// Gera o próximo trecho da página em buf; retorna 0 quando a página terminou
+typedef size_t (*http_render_t)(http_stream_t *st, char *buf, size_t size);
+
+struct http_stream {
+    bool used;
+    http_render_t render;
+    uint8_t stage;                // Trecho atual da página (uso de cada render)
+    union {
+        chart_cursor_t chart;
+#if GATEWAY_MODE
+        gateway_cursor_t gateway;
+#endif
+    } cursor;
+    uint16_t pending;             // Bytes em chunk que ainda não couberam no buffer do TCP
+    char chunk[HTTP_CHUNK_MAX];
+};
+
+static http_stream_t http_streams[HTTP_STREAMS];
+
+// Encerra a resposta em partes e a conexão
+static void http_stream_close(struct tcp_pcb *tpcb, http_stream_t *st)
+{
+    st->used = false;
+    tcp_arg(tpcb, NULL);
+    tcp_sent(tpcb, NULL);
+    tcp_err(tpcb, NULL);
+    tcp_recv(tpcb, NULL);
+    tcp_close(tpcb);
+}
+
+// Envia os próximos trechos da página enquanto houver espaço no buffer do TCP
+static err_t http_stream_continue(struct tcp_pcb *tpcb, http_stream_t *st)
+{
+    while (true)
+    {
+        if (!st->pending)
+        {
+            st->pending = st->render(st, st->chunk, sizeof(st->chunk));
+            if (!st->pending)
+            {
+                http_stream_close(tpcb, st); // Fim da página (ou trecho maior que HTTP_CHUNK_MAX)
+                return ERR_OK;
+            }
+        }
+
+        if (tcp_sndbuf(tpcb) < st->pending || tcp_sndqueuelen(tpcb) >= TCP_SND_QUEUELEN)
+        {
+            break; // Continua em http_stream_sent() quando houver espaço
+        }
+        if (tcp_write(tpcb, st->chunk, st->pending, TCP_WRITE_FLAG_COPY) != ERR_OK)
+        {
+            break;
+        }
+        st->pending = 0;
+    }
+
+    tcp_output(tpcb);
+    return ERR_OK;
+}
+
+// Função de callback chamada quando dados enviados foram confirmados
+static err_t http_stream_sent(void *arg, struct tcp_pcb *tpcb, u16_t len)
+{
+    return http_stream_continue(tpcb, (http_stream_t *)arg);
+}
+
+// Função de callback chamada quando a conexão é abortada (o PCB já foi liberado)
+static void http_stream_err(void *arg, err_t err)
+{
+    ((http_stream_t *)arg)->used = false;
+}
+
+// Inicia o envio de uma página gerada em partes por render
+static void http_stream_start(struct tcp_pcb *tpcb, http_render_t render)
+{
+    static const char header[] =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/html; charset=utf-8\r\n"
+        "Connection: close\r\n"
+        "\r\n";
+
+    http_stream_t *st = NULL;
+    for (int i = 0; i < HTTP_STREAMS; i++)
+    {
+        if (!http_streams[i].used)
+        {
+            st = &http_streams[i];
+            break;
+        }
+    }
+    if (!st)
+    {
+        tcp_close(tpcb); // Sem espaço para outra resposta simultânea
+        return;
+    }
+
+    st->used = true;
+    st->render = render;
+    st->stage = 0;
+    st->pending = 0;
+    tcp_arg(tpcb, st);
+    tcp_sent(tpcb, http_stream_sent);
+    tcp_err(tpcb, http_stream_err);
+
+    tcp_write(tpcb, header, sizeof(header) - 1, 0);
+    http_stream_continue(tpcb, st);
+}
+
+/**
+ * @brief Trechos da página principal
+ */
+enum page_stage {
+    PAGE_HEAD,
+    PAGE_BODY,
+    PAGE_DATA,
+    PAGE_FORECAST,
+    PAGE_CHART,
+    PAGE_FOOTER
+};
+
+/**
+ * @brief Textos fixos e formatos da página principal
+ *
+ * Cada trecho é gerado em um buffer de HTTP_CHUNK_MAX bytes; um trecho que não
+ * cabe encerra a página. Os formatos reservam PAGE_VALUES_MAX bytes para os valores.
+ */
+#define PAGE_VALUES_MAX 96
+
+static const char page_head[] =
+    "<!DOCTYPE html>\n"
+    "<html>\n"
+    "<head>\n"
+    "<meta charset=\"utf-8\">\n"
+    "<meta name=\"viewport\" content=\"width=device-width, initial-scale=1\">\n"
+    "<title> Monitoramento de Rios </title>\n"
+    "<style>\n"
+    "body { background-color: #b5e5fb; font-family: Arial, sans-serif; text-align: center; }\n"
+    "button { font-size: 18px; margin: 6px; padding: 10px 24px; border-radius: 8px; }\n"
+    ".report_data { font-size: 18px; margin: 6px; color: #333; }\n"
+    "</style>\n"
+    "</head>\n";
+
+static const char page_body[] =
+    "<body>\n"
+    "<h1>Monitoramento de Rios</h1>\n"
+    "<form action=\"./send_report\"><button>Gerar Relatorio</button></form>\n"
+    "<form action=\"./buzzer_alert\"><button>Alerta Sonoro</button></form>\n"
+    "<form action=\"./led_alert\"><button>Alerta Visual</button></form>\n";
+
+static const char page_data_format[] =
+    "<p class=\"report_data\">ID: %d</p>\n"
+    "<p class=\"report_data\">Nivel do Rio Anterior: %.2f</p>\n"
+    "<p class=\"report_data\">Nivel Atual do Rio: %.2f</p>\n"
+    "<p class=\"report_data\">Diff do nivel(%%): %.2f </p>\n"
+    "<p class=\"report_data\">Intensidade de Chuva: %.2f</p>\n"
+    "<p class=\"report_data\">status: %s</p>\n"
+    "<p class=\"report_data\">Tendencia: %+.2f m/h</p>\n";
+
+static const char page_forecast_format[] =
+    "<p class=\"report_data\">Previsao ATENCAO: %s</p>\n"
+    "<p class=\"report_data\">Previsao ALERTA: %s</p>\n"
+    "<p class=\"report_data\">Previsao PERIGO: %s</p>\n";
+
+static const char page_footer[] = "</body>\n</html>\n";
+
+_Static_assert(sizeof(page_head) <= HTTP_CHUNK_MAX, "page_head maior que HTTP_CHUNK_MAX");
+_Static_assert(sizeof(page_body) <= HTTP_CHUNK_MAX, "page_body maior que HTTP_CHUNK_MAX");
+_Static_assert(sizeof(page_data_format) + PAGE_VALUES_MAX <= HTTP_CHUNK_MAX, "page_data_format maior que HTTP_CHUNK_MAX");
+_Static_assert(sizeof(page_forecast_format) + PAGE_VALUES_MAX <= HTTP_CHUNK_MAX, "page_forecast_format maior que HTTP_CHUNK_MAX");
+_Static_assert(sizeof(page_footer) <= HTTP_CHUNK_MAX, "page_footer maior que HTTP_CHUNK_MAX");
+_Static_assert(CHART_CHUNK_MIN <= HTTP_CHUNK_MAX, "CHART_CHUNK_MIN maior que HTTP_CHUNK_MAX");
+
+// Gera a página principal: dados do último relatório e gráfico das últimas horas
+static size_t render_status_page(http_stream_t *st, char *buf, size_t size)
+{
+    int n = 0;
+
+    switch (st->stage)
+    {
+    case PAGE_HEAD:
+        n = snprintf(buf, size, "%s", page_head);
+        break;
+
+    case PAGE_BODY:
+        n = snprintf(buf, size, "%s", page_body);
+        break;
+
+    case PAGE_DATA:
+        n = snprintf(buf, size, page_data_format,
+            w.ID, w.last_river_l, w.curr_river_l, w.diff, w.curr_rain_i, w.status, w.trend);
+        break;
+
+    case PAGE_FORECAST:
+    {
+        char eta_attention[20], eta_alert[20], eta_danger[20];
+        format_eta(eta_attention, sizeof(eta_attention), w.eta_attention);
+        format_eta(eta_alert, sizeof(eta_alert), w.eta_alert);
+        format_eta(eta_danger, sizeof(eta_danger), w.eta_danger);
+
+        n = snprintf(buf, size, page_forecast_format,
+            eta_attention, eta_alert, eta_danger);
+
+        //A escala do gráfico acompanha a configuração atual
+        chart_scale_t scale = current_chart_scale();
+        chart_cursor_init(&st->cursor.chart, &level_history, &scale);
+        break;
+    }
+
+    case PAGE_CHART:
+        // O gráfico ocupa vários trechos; a página só avança quando ele termina
+        n = chart_render(&level_history, &st->cursor.chart, buf, size);
+        if (!chart_render_done(&st->cursor.chart))
+        {
+            return n;
+        }
+        break;
+
+    case PAGE_FOOTER:
+        n = snprintf(buf, size, "%s", page_footer);
+        break;
+
+    default:
+        return 0;
+    }
+
+    if (n <= 0 || (size_t)n >= size)
+    {
+        return 0;
+    }
+
+    st->stage++;
+    return n;
+}
+
+#if GATEWAY_MODE
+// Gera a página consolidada do gateway
+static size_t render_gateway_page(http_stream_t *st, char *buf, size_t size)
+{
+    if (st->stage == 0)
+    {
+        gateway_cursor_init(&st->cursor.gateway);
+        st->stage = 1;
+    }
+    if (gateway_render_done(&st->cursor.gateway))
+    {
+        return 0;
+    }
+    return gateway_render(&gateway, &st->cursor.gateway, buf, size, to_ms_since_boot(get_absolute_time()));
+}
+#endif
+
+// Envia uma resposta HTTP completa e encerra a conexão
+static void send_http_response(struct tcp_pcb *tpcb, const char *status, const char *type, const char *body, size_t len)
+{
+    char header[160];
+    int n = snprintf(header, sizeof(header),
+        "HTTP/1.1 %s\r\n"
+        "Content-Type: %s\r\n"
+        "Content-Length: %u\r\n"
+        "Connection: close\r\n"
+        "\r\n",
+        status, type, (unsigned)len);
+
+    tcp_write(tpcb, header, n, TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE);
+    tcp_write(tpcb, body, len, TCP_WRITE_FLAG_COPY);
+    tcp_output(tpcb);
+    tcp_recv(tpcb, NULL);
+    tcp_close(tpcb);
+}
+
+// Verifica o cabeçalho "Authorization: Bearer <token>" do request
+static bool request_authorized(const char *request)
+{
+    static const char prefix[] = "Authorization: Bearer ";
+    const char *line = request;
+
+    while ((line = strstr(line, "\r\n")) != NULL)
+    {
+        line += 2;
+        if (*line == '\r')
+        {
+            break; // Fim dos cabeçalhos
+        }
+        if (strncasecmp(line, prefix, sizeof(prefix) - 1) == 0)
+        {
+            const char *token = line + sizeof(prefix) - 1;
+            return config_check_token(token, strcspn(token, "\r\n"));
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Trata GET /config (consulta) e POST /config (alteração) da configuração da estação
+ *
+ * O POST recebe os campos a alterar no formato de formulário, por exemplo:
+ * curl -H "Authorization: Bearer <token>" -d "alert_level=6.5&report_slow_ms=600000" http://<ip>/config
+ */
+static void config_request(struct tcp_pcb *tpcb, const char *request, size_t request_len)
+{
+    static char response[768];
+    const char *error = NULL;
+
+    if (config_token_is_default())
+    {
+        static const char disabled[] = "desativado: defina CONFIG_TOKEN em site_config.h\n";
+        send_http_response(tpcb, "403 Forbidden", "text/plain", disabled, sizeof(disabled) - 1);
+        return;
+    }
+
+    if (!request_authorized(request))
+    {
+        static const char denied[] = "nao autorizado\n";
+        send_http_response(tpcb, "401 Unauthorized", "text/plain", denied, sizeof(denied) - 1);
+        return;
+    }
+
+    if (type_request == CONFIG_POST && !config_update_ready())
+    {
+        static const char busy[] = "alteracao anterior ainda sendo aplicada, tente novamente\n";
+        send_http_response(tpcb, "503 Service Unavailable", "text/plain", busy, sizeof(busy) - 1);
+        return;
+    }
+
+    if (type_request == CONFIG_POST)
+    {
+        const char *body = strstr(request, "\r\n\r\n");
+        const char *length = strstr(request, "Content-Length:");
+        size_t body_len = body ? request_len - (body + 4 - request) : 0;
+
+        if (!body || (length && strtoul(length + 15, NULL, 10) != body_len))
+        {
+            error = request_len >= HTTP_REQUEST_MAX ? "requisicao muito grande" : "corpo da requisicao incompleto";
+        }else {
+            config_update(body + 4, body_len, &error);
+        }
+    }
+
+    if (error)
+    {
+        int n = snprintf(response, sizeof(response), "%s\n", error);
+        send_http_response(tpcb, "400 Bad Request", "text/plain", response, n);
+        return;
+    }
+
+    size_t len = config_format_json(config_get(), response, sizeof(response));
+    send_http_response(tpcb, "200 OK", "application/json", response, len);
+}
+
+/**
+ * @brief Request em recepção, compartilhado pelas conexões (os callbacks do lwIP não são reentrantes)
+ *
+ * Um request que não chegou inteiro em um segmento TCP fica no buffer até
+ * completar; enquanto isso, outras conexões recebem HTTP 503.
+ */
+static char request_buffer[HTTP_REQUEST_MAX + 1];
+static uint16_t request_len;
+static struct tcp_pcb *request_owner;   // Conexão com request incompleto no buffer (NULL se nenhuma)
+static uint32_t request_started_ms;
+
+/**
+ * @brief Verifica se o request tem todos os cabeçalhos e o corpo indicado em Content-Length
+ *
+ * Um request que ocupa todo o buffer é considerado completo (e tratado truncado).
+ */
+static bool request_complete(const char *request, size_t len)
+{
+    const char *body = strstr(request, "\r\n\r\n");
+
+    if (len >= HTTP_REQUEST_MAX)
+    {
+        return true;
+    }
+    if (!body)
+    {
+        return false;
+    }
+
+    const char *length = strstr(request, "Content-Length:");
+    return !length || length > body || len - (body + 4 - request) >= strtoul(length + 15, NULL, 10);
+}
+
 // Função de callback ao aceitar conexões TCP
 static err_t tcp_server_accept(void *arg, struct tcp_pcb *newpcb, err_t err)
 {
+    // Um PCB reaproveitado não continua o request incompleto da conexão anterior
+    if (newpcb == request_owner)
+    {
+        request_owner = NULL;
+    }
     tcp_recv(newpcb, tcp_server_recv);
     return ERR_OK;
 }
@@ -411,6 +1259,8 @@ static err_t tcp_server_accept(void *arg, struct tcp_pcb *newpcb, err_t err)
 // Tratamento do request do usuário - digite aqui
 void user_request(char **request){
 
+    type_request = -1;
+
     if (strstr(*request, "GET /send_report") != NULL)
     {
         type_request = SEND_REPORT;
@@ -431,64 +1281,99 @@ void user_request(char **request){
         /** @todo Implementar alerta através do LED RGB para parte 2 */
         // type_request = LED_ALERT;
     }
+    else if (strstr(*request, "GET /gateway") != NULL)
+    {
+        type_request = SHOW_GATEWAY;
+    }
+    else if (strstr(*request, "GET /config") != NULL)
+    {
+        type_request = CONFIG_GET;
+    }
+    else if (strstr(*request, "POST /config") != NULL)
+    {
+        type_request = CONFIG_POST;
+    }
 };
 
 // Função de callback para processar requisições HTTP
 static err_t tcp_server_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err)
 {
+    // Conexão com resposta em partes em andamento: dados adicionais do cliente são ignorados
+    if (arg)
+    {
+        if (!p)
+        {
+            http_stream_close(tpcb, (http_stream_t *)arg);
+            return ERR_OK;
+        }
+        tcp_recved(tpcb, p->tot_len);
+        pbuf_free(p);
+        return ERR_OK;
+    }
+
     if (!p)
     {
+        if (tpcb == request_owner)
+        {
+            request_owner = NULL;
+        }
         tcp_close(tpcb);
         tcp_recv(tpcb, NULL);
         return ERR_OK;
     }
 
-    // Alocação do request na memória dinámica
-    char *request = (char *)malloc(p->len + 1);
-    memcpy(request, p->payload, p->len);
-    request[p->len] = '\0';
+    // Outra conexão está completando um request no buffer (descartado se parado há muito tempo)
+    uint32_t now = to_ms_since_boot(get_absolute_time());
+    if (request_owner && request_owner != tpcb && now - request_started_ms < HTTP_REQUEST_TIMEOUT_MS)
+    {
+        static const char busy[] = "servidor ocupado, tente novamente\n";
+        tcp_recved(tpcb, p->tot_len);
+        pbuf_free(p);
+        send_http_response(tpcb, "503 Service Unavailable", "text/plain", busy, sizeof(busy) - 1);
+        return ERR_OK;
+    }
+    if (request_owner != tpcb)
+    {
+        request_len = 0;
+        request_started_ms = now;
+    }
+
+    // Cópia do request para um buffer estático (os callbacks do lwIP não são reentrantes)
+    request_len += pbuf_copy_partial(p, request_buffer + request_len, HTTP_REQUEST_MAX - request_len, 0);
+    request_buffer[request_len] = '\0';
+    tcp_recved(tpcb, p->tot_len);
+    pbuf_free(p);
+
+    // O corpo de um POST pode chegar em segmentos seguintes: aguarda até completar o request
+    if (!request_complete(request_buffer, request_len))
+    {
+        request_owner = tpcb;
+        return ERR_OK;
+    }
+    request_owner = NULL;
+    char *request = request_buffer;
 
     printf("Request: %s\n", request);
 
     // Tratamento de request - Controle dos LEDs
     user_request(&request);
 
-    char html[2048];
-        snprintf(html, sizeof(html), // Formatar uma string e armazená-la em um buffer de caracteres
-        "HTTP/1.1 200 OK\r\n"
-        "Content-Type: text/html\r\n"
-        "\r\n"
-        "<!DOCTYPE html>\n"
-        "<html>\n"
-        "<head>\n"
-        "<title> Monitoramento de Rios </title>\n"
-        "<style>\n"
-        "body { background-color: #b5e5fb; font-fam </button></form>\n"
-        "<form action=\"./buzzer_alert\"><button>Alerta Sonoro</button></form>\n"
-        "<form action=\"./led_alert\"><button>Alerta Visual</button></form>\n"
-        "<p class=\"report_data\">ID: %d</p>\n"
-        "<p class=\"report_data\">Nivel do Rio Anterior: %.2f</p>\n"
-        "<p class=\"report_data\">Nivel Atual do Rio: %.2f</p>\n"
-        "<p class=\"report_data\">Diff do nivel(%): %.2f </p>\n"
-        "<p class=\"report_data\">Intensidade de Chuva: %.2f</p>\n"
-        "<p class=\"report_data\">status: %s</p>\n"
-        "</body>\n"
-        "</html>\n",
-        w.ID, w.last_river_l, w.curr_river_l, w.diff, w.curr_rain_i, w.status
-    );
-    
-    
-    // Escreve dados para envio (mas não os envia imediatamente).
-    tcp_write(tpcb, html, strlen(html), TCP_WRITE_FLAG_COPY);
+    if (type_request == CONFIG_GET || type_request == CONFIG_POST)
+    {
+        config_request(tpcb, request, request_len);
+        return ERR_OK;
+    }
 
-    // Envia a mensagem
-    tcp_output(tpcb);
+#if GATEWAY_MODE
+    if (type_request == SHOW_GATEWAY)
+    {
+        http_stream_start(tpcb, render_gateway_page);
+        return ERR_OK;
+    }
+#endif
 
-    //libera memória alocada dinamicamente
-    free(request);
-    
-    //libera um buffer de pacote (pbuf) que foi alocado anteriormente
-    pbuf_free(p);
+    // Página principal, enviada em partes (o gráfico não cabe em um único buffer)
+    http_stream_start(tpcb, render_status_page);
 
     return ERR_OK;
 }
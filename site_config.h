@@ -0,0 +1,127 @@
+#ifndef SITE_CONFIG_H
+#define SITE_CONFIG_H
+
+/**
+ * Configurações específicas de cada local de instalação
+ *
+ * Todos os valores podem ser redefinidos na configuração do CMake, por exemplo:
+ * cmake .. -DSITE_DEFINES="SCHED_SLOW_SAMPLE_MS=60000;SCHED_SLOW_REPORT_MS=600000"
+ */
+
+/**
+ * @brief Ritmo rápido: status ALERTA/PERIGO ou nível variando rapidamente
+ */
+#ifndef SCHED_FAST_SAMPLE_MS
+#define SCHED_FAST_SAMPLE_MS 1000
+#endif
+#ifndef SCHED_FAST_REPORT_MS
+#define SCHED_FAST_REPORT_MS 10000
+#endif
+
+/**
+ * @brief Ritmo normal: status ATENÇÃO ou nível variando moderadamente
+ */
+#ifndef SCHED_NORMAL_SAMPLE_MS
+#define SCHED_NORMAL_SAMPLE_MS 5000
+#endif
+#ifndef SCHED_NORMAL_REPORT_MS
+#define SCHED_NORMAL_REPORT_MS 60000
+#endif
+
+/**
+ * @brief Ritmo lento: status SEGURO com o rio calmo
+ */
+#ifndef SCHED_SLOW_SAMPLE_MS
+#define SCHED_SLOW_SAMPLE_MS 30000
+#endif
+#ifndef SCHED_SLOW_REPORT_MS
+#define SCHED_SLOW_REPORT_MS 300000
+#endif
+
+/**
+ * @brief Taxas de variação do nível (m/h, em módulo) que definem o ritmo
+ *
+ * Acima de SCHED_FAST_RATE usa o ritmo rápido; abaixo de SCHED_CALM_RATE o
+ * rio é considerado calmo.
+ */
+#ifndef SCHED_FAST_RATE
+#define SCHED_FAST_RATE 0.5f
+#endif
+#ifndef SCHED_CALM_RATE
+#define SCHED_CALM_RATE 0.05f
+#endif
+
+/**
+ * @brief Tempo (ms) em condição mais calma antes de reduzir o ritmo
+ */
+#ifndef SCHED_HOLD_MS
+#define SCHED_HOLD_MS 300000
+#endif
+
+/**
+ * Valores iniciais da configuração da estação (inc/config.h), usados enquanto
+ * nenhuma configuração foi gravada na flash pelo endpoint /config
+ */
+#ifndef WIFI_SSID
+#define WIFI_SSID "SEU SSID"
+#endif
+#ifndef WIFI_PASSWORD
+#define WIFI_PASSWORD "SUA SENHA"
+#endif
+
+/**
+ * @brief Token exigido no cabeçalho "Authorization: Bearer <token>" dos endpoints /config
+ *
+ * Enquanto o token ativo for o valor de exemplo, os endpoints /config ficam desativados.
+ */
+#define CONFIG_TOKEN_PLACEHOLDER "troque-este-token"
+#ifndef CONFIG_TOKEN
+#define CONFIG_TOKEN CONFIG_TOKEN_PLACEHOLDER
+#endif
+
+/**
+ * @brief Versão do firmware gravada com a configuração (pico_set_program_version no CMakeLists.txt)
+ *
+ * Um registro gravado por outra versão é descartado na inicialização.
+ */
+#ifndef CONFIG_FIRMWARE_VERSION
+#ifdef PICO_PROGRAM_VERSION_STRING
+#define CONFIG_FIRMWARE_VERSION PICO_PROGRAM_VERSION_STRING
+#else
+#define CONFIG_FIRMWARE_VERSION "0"
+#endif
+#endif
+
+/**
+ * @brief Calibração: nível normal do rio (m), chuva no fundo de escala (%) e zona morta do ADC
+ */
+#ifndef CONFIG_RIVER_LEVEL
+#define CONFIG_RIVER_LEVEL 5.0f
+#endif
+#ifndef CONFIG_INTENSE_RAIN
+#define CONFIG_INTENSE_RAIN 100.0f
+#endif
+#ifndef CONFIG_ADC_LOW
+#define CONFIG_ADC_LOW 1800
+#endif
+#ifndef CONFIG_ADC_HIGH
+#define CONFIG_ADC_HIGH 2100
+#endif
+
+/**
+ * @brief Limites de classificação: níveis (m) de ALERTA/PERIGO e intensidades de chuva (%)
+ */
+#ifndef CONFIG_ALERT_LEVEL
+#define CONFIG_ALERT_LEVEL 7.0f
+#endif
+#ifndef CONFIG_DANGER_LEVEL
+#define CONFIG_DANGER_LEVEL 9.0f
+#endif
+#ifndef CONFIG_RAIN_ALERT
+#define CONFIG_RAIN_ALERT 50.0f
+#endif
+#ifndef CONFIG_RAIN_ATTENTION
+#define CONFIG_RAIN_ATTENTION 70.0f
+#endif
+
+#endif /* SITE_CONFIG_H */
@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+"""
+Relatório de uso de pilha por callback e verificação de uso de heap.
+
+Lê os arquivos .ci gerados pelo GCC com -fcallgraph-info=su, monta o grafo de
+chamadas do firmware e, para cada função raiz informada (callbacks e funções
+executadas em tempo de execução), calcula o pior caso de profundidade de pilha
+e verifica se alguma função de alocação dinâmica é alcançável.
+
+Uso: stack_report.py <diretorio_build> <raiz> [<raiz> ...]
+
+Retorna 1 se alguma raiz puder chamar malloc/calloc/realloc/free (inclusive
+pelas formas __wrap_/__real_ geradas pelo --wrap do SDK). Funções chamadas sem
+informação de pilha (bibliotecas pré-compiladas) contam como 0 bytes e são
+listadas no relatório: o pior caso é então um limite inferior.
+"""
+import os
+import re
+import sys
+
+HEAP_FUNCTIONS = {
+    "malloc", "calloc", "realloc", "free", "memalign", "aligned_alloc",
+    "strdup", "strndup", "_malloc_r", "_calloc_r", "_realloc_r", "_free_r",
+}
+INDIRECT = "__indirect_call"
+
+NODE_RE = re.compile(r'node: \{ title: "([^"]+)" label: "([^"]*)"')
+EDGE_RE = re.compile(r'edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+STACK_RE = re.compile(r'\\n(\d+) bytes \(([^)]+)\)')
+
+
+def load_graph(build_dir):
+    stack = {}      # função -> (bytes, qualificador)
+    edges = {}      # função -> conjunto de funções chamadas
+    for root, _, files in os.walk(build_dir):
+        for name in files:
+            if not name.endswith(".ci"):
+                continue
+            with open(os.path.join(root, name), encoding="utf-8", errors="replace") as f:
+                for line in f:
+                    m = NODE_RE.match(line)
+                    if m:
+                        s = STACK_RE.search(m.group(2))
+                        if s:
+                            stack[m.group(1)] = (int(s.group(1)), s.group(2))
+                        continue
+                    m = EDGE_RE.match(line)
+                    if m:
+                        edges.setdefault(m.group(1), set()).add(m.group(2))
+    return stack, edges
+
+
+def is_heap(name):
+    """O SDK substitui malloc/free com --wrap: __wrap_malloc chama __real_malloc."""
+    name = name.split(":")[-1]
+    for prefix in ("__wrap_", "__real_"):
+        if name.startswith(prefix):
+            name = name[len(prefix):]
+    return name in HEAP_FUNCTIONS
+
+
+def resolve(name, stack):
+    """Funções substituídas com --wrap (ex.: printf do SDK) são definidas como __wrap_<nome>."""
+    if name not in stack and "__wrap_" + name in stack:
+        return "__wrap_" + name
+    return name
+
+
+def find_root(name, stack):
+    for title in stack:
+        if title == name or title.endswith(":" + name):
+            return title
+    return None
+
+
+def analyse(func, stack, edges, path, memo):
+    """Retorna (pior caso de pilha, caminho até heap ou None, notas)."""
+    if func in memo:
+        return memo[func]
+    if func in path:
+        return 0, None, {"recursão: " + func.split(":")[-1]}
+
+    own, qualifier = stack.get(func, (0, "static"))
+    notes = set()
+    if is_heap(func):
+        return 0, [func.split(":")[-1]], notes
+    if func not in stack and func != INDIRECT:
+        notes.add("sem informação: " + func.split(":")[-1])
+    if qualifier.startswith("dynamic"):
+        notes.add("pilha dinâmica: " + func.split(":")[-1])
+    if func == INDIRECT:
+        return 0, None, {"chamada indireta"}
+
+    worst = 0
+    heap_path = None
+    path.add(func)
+    for callee in sorted(edges.get(func, ())):
+        if not is_heap(callee):
+            callee = resolve(callee, stack)
+        depth, heap, callee_notes = analyse(callee, stack, edges, path, memo)
+        worst = max(worst, depth)
+        notes |= callee_notes
+        if heap and heap_path is None:
+            heap_path = [func.split(":")[-1]] + heap
+    path.discard(func)
+
+    memo[func] = (own + worst, heap_path, notes)
+    return memo[func]
+
+
+def main():
+    if len(sys.argv) < 3:
+        print(__doc__.strip())
+        return 2
+
+    stack, edges = load_graph(sys.argv[1])
+    if not stack:
+        print("Nenhum arquivo .ci encontrado (compile com -fcallgraph-info=su)")
+        return 2
+
+    memo = {}
+    failed = False
+    print("%-28s %12s  %s" % ("Raiz", "Pilha (B)", "Observações"))
+    for name in sys.argv[2:]:
+        root = find_root(name, stack)
+        if root is None:
+            print("%-28s %12s  %s" % (name, "-", "não encontrada"))
+            continue
+
+        depth, heap_path, notes = analyse(root, stack, edges, set(), memo)
+        indirect = "chamada indireta" in notes
+        summary = [n for n in sorted(notes) if n.startswith(("recursão", "pilha dinâmica"))]
+        if indirect:
+            summary.append("possui chamadas indiretas (não contabilizadas)")
+        unknown = sorted(n.split(": ", 1)[1] for n in notes if n.startswith("sem informação"))
+        bound = ">=" if unknown or indirect else ""
+        print("%-28s %12s  %s" % (name, bound + str(depth), "; ".join(summary)))
+        if unknown:
+            print("  sem informação de pilha (contadas como 0 B): " + ", ".join(unknown))
+
+        if heap_path:
+            failed = True
+            print("  ERRO: alocação dinâmica alcançável: " + " -> ".join(heap_path))
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""
+Testes de stack_report.py com grafos de chamadas sintéticos, no formato dos
+arquivos .ci gerados pelo GCC com -fcallgraph-info=su.
+
+Uso: python3 tools/test_stack_report.py
+"""
+import contextlib
+import io
+import os
+import sys
+import tempfile
+import unittest
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import stack_report  # noqa: E402
+
+
+def node(title, stack=None):
+    label = title.split(":")[-1] + "\\nx.c:1:1"
+    if stack is not None:
+        label += "\\n%d bytes (static)" % stack
+        return 'node: { title: "%s" label: "%s" }\n' % (title, label)
+    return 'node: { title: "%s" label: "%s" shape : ellipse }\n' % (title, label)
+
+
+def edge(source, target):
+    return 'edge: { sourcename: "%s" targetname: "%s" label: "x.c:1:1" }\n' % (source, target)
+
+
+class StackReportTest(unittest.TestCase):
+    def run_report(self, files, *roots):
+        with tempfile.TemporaryDirectory() as build_dir:
+            for name, text in files.items():
+                with open(os.path.join(build_dir, name), "w", encoding="utf-8") as f:
+                    f.write('graph: { title: "%s"\n%s}\n' % (name, text))
+            out = io.StringIO()
+            argv = sys.argv
+            sys.argv = ["stack_report.py", build_dir] + list(roots)
+            try:
+                with contextlib.redirect_stdout(out):
+                    code = stack_report.main()
+            finally:
+                sys.argv = argv
+        return code, out.getvalue()
+
+    def test_wrapped_malloc(self):
+        # Com pico_malloc no build, malloc é definido como __wrap_malloc, que chama __real_malloc
+        files = {
+            "main.ci": node("root", 16) + node("main.c:inner", 64) + node("malloc")
+                       + edge("root", "main.c:inner") + edge("main.c:inner", "malloc"),
+            "pico_malloc.ci": node("__wrap_malloc", 24) + node("__real_malloc")
+                              + edge("__wrap_malloc", "__real_malloc"),
+        }
+        code, out = self.run_report(files, "root")
+        self.assertEqual(code, 1)
+        self.assertIn("root -> inner -> malloc", out)
+
+    def test_real_heap_call(self):
+        files = {"main.ci": node("root", 16) + node("_malloc_r") + node("__real_free")
+                            + edge("root", "__real_free")}
+        code, out = self.run_report(files, "root")
+        self.assertEqual(code, 1)
+        self.assertIn("root -> __real_free", out)
+
+    def test_clean_root(self):
+        files = {"main.ci": node("root", 16) + node("main.c:leaf", 32) + edge("root", "main.c:leaf")}
+        code, out = self.run_report(files, "root")
+        self.assertEqual(code, 0)
+        self.assertIn(" 48 ", out)
+        self.assertNotIn("ERRO", out)
+
+    def test_unknown_callee_listed(self):
+        files = {"main.ci": node("root", 16) + node("memcpy") + edge("root", "memcpy")}
+        code, out = self.run_report(files, "root")
+        self.assertEqual(code, 0)
+        self.assertIn(">=16", out)
+        self.assertIn("sem informação de pilha (contadas como 0 B): memcpy", out)
+
+
+if __name__ == "__main__":
+    unittest.main()